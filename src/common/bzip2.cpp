@@ -0,0 +1,516 @@
+#include "bzip2.hpp"
+#include "thread_pool.hpp"
+#include "checksum.hpp"
+#include "budget.hpp"
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HEXDIG_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr uint64_t MASK48 = (1ULL << 48) - 1;
+
+// A magic starting s bits into byte p-1 fully determines bytes p and p+1,
+// whatever the shift, so those two bytes are the search key: 2 magics x 8
+// shifts give 16 (byte, byte) pairs, and only their positions are verified.
+struct KeyTable {
+    std::array<uint8_t, 16> first;
+    std::array<uint8_t, 16> second;
+    std::bitset<65536> pairs;
+
+    KeyTable() {
+        int k = 0;
+        for (uint64_t magic : {BZ2_BLOCK_MAGIC, BZ2_EOS_MAGIC}) {
+            for (int s = 0; s < 8; ++s, ++k) {
+                uint64_t window = magic << (8 - s);   // 56-bit window starting at byte p-1
+                first[k] = static_cast<uint8_t>(window >> 40);
+                second[k] = static_cast<uint8_t>(window >> 32);
+                pairs.set((first[k] << 8) | second[k]);
+            }
+        }
+    }
+};
+
+const KeyTable& keys() {
+    static const KeyTable table;
+    return table;
+}
+
+uint64_t loadWindow(const uint8_t* data, size_t size, size_t start) {
+    uint8_t buf[8] = {};
+    if (start >= size)
+        return 0;
+    size_t n = size - start < 8 ? size - start : 8;
+    std::memcpy(buf, data + start, n);
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i)
+        v = (v << 8) | buf[i];
+    return v;
+}
+
+// Checks every shift of both magics for a key at byte p; returns the lowest
+// matching bit offset that is >= fromBit and fits in the data.
+bool verify(const uint8_t* data, size_t size, size_t p, uint64_t fromBit, Bzip2Marker& marker) {
+    uint64_t v = loadWindow(data, size, p - 1);
+    for (unsigned s = 0; s < 8; ++s) {
+        uint64_t bit = static_cast<uint64_t>(p - 1) * 8 + s;
+        if (bit < fromBit || bit + 48 > static_cast<uint64_t>(size) * 8)
+            continue;
+        uint64_t candidate = (v >> (16 - s)) & MASK48;
+        if (candidate == BZ2_BLOCK_MAGIC || candidate == BZ2_EOS_MAGIC) {
+            marker.bit = bit;
+            marker.eos = candidate == BZ2_EOS_MAGIC;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool findScalar(const uint8_t* data, size_t size, size_t p, uint64_t fromBit, Bzip2Marker& marker) {
+    const auto& pairs = keys().pairs;
+    for (; p + 1 < size; ++p) {
+        if (pairs.test((data[p] << 8) | data[p + 1]) && verify(data, size, p, fromBit, marker))
+            return true;
+    }
+    return false;
+}
+
+#ifdef HEXDIG_X86_SIMD
+__attribute__((target("sse2")))
+bool findSSE2(const uint8_t* data, size_t size, size_t p, uint64_t fromBit, Bzip2Marker& marker) {
+    const KeyTable& k = keys();
+    __m128i first[16], second[16];
+    for (int i = 0; i < 16; ++i) {
+        first[i] = _mm_set1_epi8(static_cast<char>(k.first[i]));
+        second[i] = _mm_set1_epi8(static_cast<char>(k.second[i]));
+    }
+
+    for (; p + 17 <= size; p += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + p));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + p + 1));
+        __m128i hit = _mm_setzero_si128();
+        for (int i = 0; i < 16; ++i)
+            hit = _mm_or_si128(hit, _mm_and_si128(_mm_cmpeq_epi8(a, first[i]),
+                                                  _mm_cmpeq_epi8(b, second[i])));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+        while (mask) {
+            size_t q = p + __builtin_ctz(mask);
+            if (verify(data, size, q, fromBit, marker))
+                return true;
+            mask &= mask - 1;
+        }
+    }
+    return findScalar(data, size, p, fromBit, marker);
+}
+#endif
+
+using FindFn = bool (*)(const uint8_t*, size_t, size_t, uint64_t, Bzip2Marker&);
+
+FindFn selectFind() {
+#ifdef HEXDIG_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) return findSSE2;
+#endif
+    return findScalar;
+}
+
+const FindFn findImpl = selectFind();
+
+bool isHeader(const uint8_t* data, size_t size, size_t offset) {
+    return offset + 4 <= size &&
+           data[offset] == 'B' && data[offset + 1] == 'Z' && data[offset + 2] == 'h' &&
+           data[offset + 3] >= '1' && data[offset + 3] <= '9';
+}
+
+} // namespace
+
+uint32_t bzip2_read_bits(const uint8_t* data, size_t size, uint64_t bit, unsigned count) {
+    uint64_t v = loadWindow(data, size, static_cast<size_t>(bit / 8));
+    return static_cast<uint32_t>((v << (bit % 8)) >> (64 - count));
+}
+
+bool bzip2_next_marker(const uint8_t* data, size_t size, uint64_t fromBit, Bzip2Marker& marker) {
+    size_t p = static_cast<size_t>(fromBit / 8) + 1;
+    if (p >= size)
+        return false;
+    return findImpl(data, size, p, fromBit, marker);
+}
+
+bool bzip2_scan_member(const uint8_t* data, size_t size, size_t offset, Bzip2Member& member) {
+    member = Bzip2Member();
+    member.offset = offset;
+    if (!isHeader(data, size, offset))
+        return false;
+    member.level = data[offset + 3] - '0';
+
+    // The first magic must follow the header directly
+    uint64_t bit = static_cast<uint64_t>(offset + 4) * 8;
+    Bzip2Marker marker;
+    if (!bzip2_next_marker(data, size, bit, marker) || marker.bit != bit)
+        return false;
+
+    uint32_t combined = 0;
+    while (!marker.eos) {
+        // Out of budget: the member ends at the blocks found so far
+        if (!budgetOk()) {
+            member.length = static_cast<size_t>(marker.bit / 8) - offset;
+            return true;
+        }
+        Bzip2Block block;
+        block.bitOffset = marker.bit;
+        block.crc = bzip2_read_bits(data, size, marker.bit + 48, 32);
+        combined = ((combined << 1) | (combined >> 31)) ^ block.crc;
+
+        if (!bzip2_next_marker(data, size, marker.bit + 48, marker)) {
+            // Truncated: the last block runs to the end of the data
+            block.bitLength = static_cast<uint64_t>(size) * 8 - block.bitOffset;
+            member.blocks.push_back(block);
+            member.length = size - offset;
+            return true;
+        }
+        block.bitLength = marker.bit - block.bitOffset;
+        member.blocks.push_back(block);
+    }
+
+    uint64_t end = marker.bit + 48 + 32;
+    if (end > static_cast<uint64_t>(size) * 8) {
+        member.length = size - offset;
+        return true;
+    }
+    member.complete = true;
+    member.combinedCrc = bzip2_read_bits(data, size, marker.bit + 48, 32);
+    member.crcMatches = member.combinedCrc == combined;
+    member.length = static_cast<size_t>((end + 7) / 8) - offset;
+    return true;
+}
+
+//
+// Block decoder
+//
+namespace {
+
+constexpr int BZ_MAX_GROUPS = 6;
+constexpr int BZ_MAX_ALPHA = 258;
+constexpr int BZ_MAX_CODE_LEN = 20;
+constexpr int BZ_GROUP_SIZE = 50;
+constexpr int BZ_FAST_BITS = 10;
+
+// MSB-first reader; reads past the end yield zero bits and set `overrun`
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size, uint64_t bit)
+        : data(data), size(size), pos(static_cast<size_t>(bit / 8)) {
+        refill();
+        consume(static_cast<unsigned>(bit % 8));
+    }
+
+    uint32_t peek(unsigned n) {
+        if (count < n) refill();
+        return static_cast<uint32_t>(acc >> (64 - n));
+    }
+
+    void consume(unsigned n) {
+        if (count < n) refill();
+        acc <<= n;
+        count -= n;
+    }
+
+    uint32_t bits(unsigned n) {
+        uint32_t v = peek(n);
+        consume(n);
+        return v;
+    }
+
+    bool overrun() const { return padding > 8; }
+
+private:
+    void refill() {
+        while (count <= 56) {
+            uint64_t byte = 0;
+            if (pos < size) byte = data[pos++];
+            else ++padding;
+            acc |= byte << (56 - count);
+            count += 8;
+        }
+    }
+
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    uint64_t acc = 0;
+    unsigned count = 0;
+    size_t padding = 0;
+};
+
+// Canonical Huffman table: codes up to BZ_FAST_BITS long are resolved by a
+// direct lookup, longer ones through the per-length limits.
+struct HuffTable {
+    int minLen = 0;
+    int maxLen = 0;
+    int limit[BZ_MAX_CODE_LEN + 1];
+    int base[BZ_MAX_CODE_LEN + 1];
+    uint16_t perm[BZ_MAX_ALPHA];
+    uint16_t fast[1 << BZ_FAST_BITS];   // (length << 9) | symbol, 0 if longer
+
+    bool build(const uint8_t* lengths, int alphaSize) {
+        minLen = BZ_MAX_CODE_LEN;
+        maxLen = 0;
+        for (int i = 0; i < alphaSize; ++i) {
+            minLen = std::min<int>(minLen, lengths[i]);
+            maxLen = std::max<int>(maxLen, lengths[i]);
+        }
+
+        int pp = 0;
+        int code = 0;
+        std::memset(fast, 0, sizeof(fast));
+        for (int len = 1; len <= BZ_MAX_CODE_LEN; ++len) {
+            int first = pp;
+            for (int sym = 0; sym < alphaSize; ++sym)
+                if (lengths[sym] == len) perm[pp++] = static_cast<uint16_t>(sym);
+            int n = pp - first;
+            base[len] = code - first;
+            limit[len] = n ? code + n - 1 : -1;
+            if (len <= BZ_FAST_BITS) {
+                for (int i = 0; i < n; ++i) {
+                    int c = code + i;
+                    if (c >= (1 << len)) return false;   // over-subscribed
+                    int shift = BZ_FAST_BITS - len;
+                    for (int f = c << shift; f < ((c + 1) << shift); ++f)
+                        fast[f] = static_cast<uint16_t>((len << 9) | perm[first + i]);
+                }
+            }
+            code = (code + n) << 1;
+        }
+        return true;
+    }
+
+    int decode(BitReader& br) const {
+        uint32_t v = br.peek(BZ_MAX_CODE_LEN);
+        uint16_t f = fast[v >> (BZ_MAX_CODE_LEN - BZ_FAST_BITS)];
+        if (f) {
+            br.consume(f >> 9);
+            return f & 0x1FF;
+        }
+        for (int len = std::max(minLen, BZ_FAST_BITS + 1); len <= maxLen; ++len) {
+            int c = static_cast<int>(v >> (BZ_MAX_CODE_LEN - len));
+            if (c <= limit[len]) {
+                int idx = c - base[len];
+                if (idx < 0 || idx >= BZ_MAX_ALPHA) return -1;
+                br.consume(len);
+                return perm[idx];
+            }
+        }
+        return -1;
+    }
+};
+
+} // namespace
+
+bool bzip2_decode_block(const uint8_t* data, size_t size, uint64_t bitOffset, int level,
+                        std::vector<uint8_t>& out) {
+    BitReader br(data, size, bitOffset);
+    uint64_t magic = (static_cast<uint64_t>(br.bits(24)) << 24) | br.bits(24);
+    if (magic != BZ2_BLOCK_MAGIC) return false;
+    uint32_t storedCrc = (br.bits(16) << 16) | br.bits(16);
+    if (br.bits(1)) return false;   // randomised blocks, obsolete since bzip2 0.9.5
+    uint32_t origPtr = br.bits(24);
+
+    // Symbol map: which byte values occur in the block
+    uint8_t seqToUnseq[256];
+    int numInUse = 0;
+    uint32_t used16 = br.bits(16);
+    for (int i = 0; i < 16; ++i) {
+        if (!(used16 & (0x8000u >> i))) continue;
+        uint32_t used = br.bits(16);
+        for (int j = 0; j < 16; ++j)
+            if (used & (0x8000u >> j)) seqToUnseq[numInUse++] = static_cast<uint8_t>(i * 16 + j);
+    }
+    if (numInUse == 0) return false;
+    int alphaSize = numInUse + 2;
+
+    int nGroups = static_cast<int>(br.bits(3));
+    if (nGroups < 2 || nGroups > BZ_MAX_GROUPS) return false;
+    int nSelectors = static_cast<int>(br.bits(15));
+    if (nSelectors < 1) return false;
+
+    std::vector<uint8_t> selectors(nSelectors);
+    uint8_t groupMtf[BZ_MAX_GROUPS] = {0, 1, 2, 3, 4, 5};
+    for (int i = 0; i < nSelectors; ++i) {
+        int j = 0;
+        while (br.bits(1)) {
+            if (++j >= nGroups) return false;
+        }
+        uint8_t g = groupMtf[j];
+        std::memmove(groupMtf + 1, groupMtf, j);
+        groupMtf[0] = g;
+        selectors[i] = g;
+        if (br.overrun()) return false;
+    }
+
+    HuffTable tables[BZ_MAX_GROUPS];
+    for (int g = 0; g < nGroups; ++g) {
+        uint8_t lengths[BZ_MAX_ALPHA];
+        int len = static_cast<int>(br.bits(5));
+        for (int sym = 0; sym < alphaSize; ++sym) {
+            for (;;) {
+                if (len < 1 || len > BZ_MAX_CODE_LEN || br.overrun()) return false;
+                if (!br.bits(1)) break;
+                len += br.bits(1) ? -1 : 1;
+            }
+            lengths[sym] = static_cast<uint8_t>(len);
+        }
+        if (!tables[g].build(lengths, alphaSize)) return false;
+    }
+
+    // Huffman + MTF + RUNA/RUNB decoding into tt (low 8 bits of each entry)
+    const size_t maxBlock = static_cast<size_t>(level) * 100000;
+    std::vector<uint32_t> tt(maxBlock);
+    uint32_t byteCount[256] = {};
+    uint8_t mtf[256];
+    for (int i = 0; i < 256; ++i) mtf[i] = static_cast<uint8_t>(i);
+
+    const int eob = numInUse + 1;
+    size_t count = 0;
+    size_t run = 0;
+    size_t runWeight = 1;
+    int groupIndex = -1;
+    int groupLeft = 0;
+    const HuffTable* table = nullptr;
+    for (;;) {
+        if (groupLeft == 0) {
+            if (++groupIndex >= nSelectors) return false;
+            table = &tables[selectors[groupIndex]];
+            groupLeft = BZ_GROUP_SIZE;
+        }
+        --groupLeft;
+
+        int sym = table->decode(br);
+        if (sym < 0 || sym > eob || br.overrun()) return false;
+
+        if (sym <= 1) {   // RUNA / RUNB: bijective base-2 run length of mtf[0]
+            run += (sym + 1) * runWeight;
+            runWeight <<= 1;
+            if (run > maxBlock) return false;
+            continue;
+        }
+        if (run) {
+            if (count + run > maxBlock) return false;
+            uint8_t b = seqToUnseq[mtf[0]];
+            std::fill(tt.begin() + count, tt.begin() + count + run, b);
+            byteCount[b] += static_cast<uint32_t>(run);
+            count += run;
+            run = 0;
+            runWeight = 1;
+        }
+        if (sym == eob) break;
+
+        if (count >= maxBlock) return false;
+        int idx = sym - 1;
+        uint8_t v = mtf[idx];
+        std::memmove(mtf + 1, mtf, idx);
+        mtf[0] = v;
+        uint8_t b = seqToUnseq[v];
+        tt[count++] = b;
+        ++byteCount[b];
+    }
+    if (origPtr >= count) return false;
+
+    // Inverse BWT: link every position to its successor in the high 24 bits
+    uint32_t cftab[256];
+    uint32_t sum = 0;
+    for (int i = 0; i < 256; ++i) {
+        cftab[i] = sum;
+        sum += byteCount[i];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t b = static_cast<uint8_t>(tt[i]);
+        tt[cftab[b]++] |= static_cast<uint32_t>(i) << 8;
+    }
+
+    // Walk the chain, undoing the initial run-length encoding (4 equal bytes
+    // are followed by a repeat count)
+    size_t start = out.size();
+    out.reserve(start + count + count / 4);
+    uint32_t pos = tt[origPtr] >> 8;
+    int last = -1;
+    int same = 0;
+    for (size_t i = 0; i < count; ++i) {
+        pos = tt[pos];
+        uint8_t b = static_cast<uint8_t>(pos);
+        pos >>= 8;
+        if (same == 4) {
+            out.insert(out.end(), b, static_cast<uint8_t>(last));
+            same = 0;
+            continue;
+        }
+        same = (b == last) ? same + 1 : 1;
+        last = b;
+        out.push_back(b);
+    }
+
+    if (crc32_msb(out.data() + start, out.size() - start) != storedCrc) {
+        out.resize(start);
+        return false;
+    }
+    return true;
+}
+
+bool bzip2_decompress(const uint8_t* data, size_t size, size_t offset, const Bzip2Sink& sink,
+                      ThreadPool* pool) {
+    if (pool && pool->size() < 2)
+        pool = nullptr;
+    // Blocks in flight at once; bounds memory to about this many 900k outputs
+    const size_t window = pool ? pool->size() * 2 : 1;
+
+    Bzip2Member member;
+    size_t cursor = offset;
+    bool any = false;
+    while (bzip2_scan_member(data, size, cursor, member)) {
+        any = true;
+        const auto& blocks = member.blocks;
+        for (size_t first = 0; first < blocks.size(); first += window) {
+            size_t n = std::min(window, blocks.size() - first);
+            std::vector<std::vector<uint8_t>> outputs(n);
+
+            if (!pool) {
+                for (size_t i = 0; i < n; ++i) {
+                    if (!bzip2_decode_block(data, size, blocks[first + i].bitOffset, member.level, outputs[i]))
+                        return false;
+                    if (!sink(outputs[i].data(), outputs[i].size()))
+                        return true;
+                }
+                continue;
+            }
+
+            std::vector<std::future<bool>> pending;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t bit = blocks[first + i].bitOffset;
+                int level = member.level;
+                std::vector<uint8_t>* out = &outputs[i];
+                pending.push_back(pool->submit([=] {
+                    return bzip2_decode_block(data, size, bit, level, *out);
+                }));
+            }
+            bool ok = true;
+            bool stop = false;
+            for (size_t i = 0; i < n; ++i) {
+                bool decoded = pool->wait(pending[i]);
+                if (!ok || stop) continue;   // drain the remaining tasks
+                if (!decoded) ok = false;
+                else if (!sink(outputs[i].data(), outputs[i].size())) stop = true;
+            }
+            if (!ok) return false;
+            if (stop) return true;
+        }
+        if (!member.complete)
+            break;
+        cursor += member.length;
+    }
+    return any;
+}
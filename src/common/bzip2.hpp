@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <functional>
+
+class ThreadPool;
+
+//
+// bzip2 stream layout: "BZh" + level ('1'..'9'), then one Huffman-coded block
+// per up to level*100k input bytes, each starting with the 48-bit magic
+// 0x314159265359 and its 32-bit CRC, then the 48-bit end-of-stream magic
+// 0x177245385090, the 32-bit combined CRC and zero bits up to the next byte.
+// Only the first block magic is byte aligned; every later magic can start at
+// any bit, so all positions here are bit offsets counted from the MSB of
+// data[0].
+//
+
+constexpr uint64_t BZ2_BLOCK_MAGIC = 0x314159265359ULL;
+constexpr uint64_t BZ2_EOS_MAGIC   = 0x177245385090ULL;
+
+struct Bzip2Marker {
+    uint64_t bit;
+    bool eos;
+};
+
+// Finds the first block or end-of-stream magic starting at or after `fromBit`.
+bool bzip2_next_marker(const uint8_t* data, size_t size, uint64_t fromBit, Bzip2Marker& marker);
+
+struct Bzip2Block {
+    uint64_t bitOffset;   // of the block magic
+    uint64_t bitLength;   // up to the next block or end-of-stream magic
+    uint32_t crc;         // CRC of the uncompressed block data
+};
+
+struct Bzip2Member {
+    size_t offset = 0;
+    size_t length = 0;    // byte length including the padding after the trailer
+    int level = 0;        // block size in units of 100k
+    std::vector<Bzip2Block> blocks;
+    bool complete = false;     // end-of-stream marker found
+    bool crcMatches = false;   // combined CRC agrees with the block CRCs
+    uint32_t combinedCrc = 0;
+};
+
+// Walks the member whose "BZh" header is at `offset`. Returns false if no
+// block or end-of-stream magic directly follows the header.
+bool bzip2_scan_member(const uint8_t* data, size_t size, size_t offset, Bzip2Member& member);
+
+// Reads `count` (1..32) bits at bit offset `bit`, MSB first
+uint32_t bzip2_read_bits(const uint8_t* data, size_t size, uint64_t bit, unsigned count);
+
+// Decodes the block whose magic is at bit `bitOffset` of a member with the
+// given level and appends its uncompressed bytes to `out`. Returns false on
+// corrupt or truncated data, or if the block CRC does not match.
+bool bzip2_decode_block(const uint8_t* data, size_t size, uint64_t bitOffset, int level,
+                        std::vector<uint8_t>& out);
+
+// Receives decompressed data in stream order; returning false stops decoding.
+using Bzip2Sink = std::function<bool(const uint8_t* data, size_t len)>;
+
+// Decompresses the members starting at `offset`. Blocks are independent once
+// their bit offsets are known, so with a pool they are decoded concurrently
+// and handed to `sink` in order. Returns false if any block failed to decode;
+// everything before the failing block has been delivered.
+bool bzip2_decompress(const uint8_t* data, size_t size, size_t offset, const Bzip2Sink& sink,
+                      ThreadPool* pool = nullptr);
@@ -1,6 +1,6 @@
 #include "cramfs.hpp"
 #include "helpers.hpp"
-CramfsInode parseInode(const std::vector<uint8_t>& b, size_t off, bool le) {
+CramfsInode parseInode(const ByteView& b, size_t off, bool le) {
     uint32_t w0 = le ? read_le32(b, off) : read_be32(b, off);
     uint32_t w1 = le ? read_le32(b, off + 4) : read_be32(b, off + 4);
     uint32_t w2 = le ? read_le32(b, off + 8) : read_be32(b, off + 8);
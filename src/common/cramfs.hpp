@@ -1,5 +1,7 @@
 #pragma once
+#include "byte_view.hpp"
 #include <cstdint>
+#include <cstddef>
 #include <vector>
 struct CramfsInode {
     uint16_t mode;      // file type + permissions
@@ -10,6 +12,6 @@ struct CramfsInode {
     uint32_t offset;    // 26-bit
 };
 
-CramfsInode parseInode(const std::vector<uint8_t>& b, size_t off, bool le);
+CramfsInode parseInode(const ByteView& b, size_t off, bool le);
 bool isDir(uint16_t mode);
 bool isReg(uint16_t mode);
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "crypto_constants.hpp"
+#include "signature_index.hpp"
+#include "aes.hpp"
+#include "crc.hpp"
+#include <sstream>
+
+namespace {
+
+std::vector<uint8_t> bytes(const uint8_t* p, size_t n) {
+    return std::vector<uint8_t>(p, p + n);
+}
+
+std::vector<uint8_t> words32(std::initializer_list<uint32_t> words, bool bigEndian) {
+    std::vector<uint8_t> out;
+    for (uint32_t w : words)
+        for (int i = 0; i < 4; ++i)
+            out.push_back(static_cast<uint8_t>(w >> (bigEndian ? 24 - 8 * i : 8 * i)));
+    return out;
+}
+
+std::vector<uint8_t> words64(std::initializer_list<uint64_t> words, bool bigEndian) {
+    std::vector<uint8_t> out;
+    for (uint64_t w : words)
+        for (int i = 0; i < 8; ++i)
+            out.push_back(static_cast<uint8_t>(w >> (bigEndian ? 56 - 8 * i : 8 * i)));
+    return out;
+}
+
+CryptoConstant crc(const std::string& width, const std::string& polyName, uint64_t poly,
+                   const std::string& endianness, size_t tableBytes, std::vector<uint8_t> sig) {
+    std::ostringstream info;
+    info << width << ", " << polyName
+         << ", polynomial=0x" << std::hex << poly << std::dec
+         << ", storage endianness=" << endianness
+         << ", confidence=high"
+         << ", entries=256, table bytes=" << tableBytes;
+    return {"CRC", info.str(), tableBytes, std::move(sig)};
+}
+
+CryptoConstant aes(const std::string& name, size_t tableBytes, const uint8_t* sig,
+                   const std::string& extra = "") {
+    std::ostringstream info;
+    info << name;
+    if (!extra.empty())
+        info << ", " << extra;
+    info << ", entries=256, table bytes=" << tableBytes;
+    return {"AES", info.str(), tableBytes, bytes(sig, 16)};
+}
+
+CryptoConstant other(const std::string& name, const std::string& layout, size_t tableBytes,
+                     std::vector<uint8_t> sig) {
+    std::string info = name;
+    if (!layout.empty())
+        info += ", " + layout;
+    info += ", table bytes=" + std::to_string(tableBytes);
+    return {"CRYPTO", info, tableBytes, std::move(sig)};
+}
+
+std::vector<CryptoConstant> buildConstants() {
+    std::vector<CryptoConstant> c;
+
+    c.push_back(crc("CRC32", "CRC-32/IEEE (poly 0x04C11DB7)", 0x04C11DB7u, "LE", 256 * 4, bytes(CRC32_IEEE_REF_LE, 16)));
+    c.push_back(crc("CRC32", "CRC-32/IEEE (poly 0x04C11DB7)", 0x04C11DB7u, "BE", 256 * 4, bytes(CRC32_IEEE_REF_BE, 16)));
+    c.push_back(crc("CRC16", "CRC-16/IBM (poly 0x8005)", 0x8005, "LE", 256 * 2, bytes(CRC16_IBM_REF_LE, 16)));
+    c.push_back(crc("CRC16", "CRC-16/IBM (poly 0x8005)", 0x8005, "BE", 256 * 2, bytes(CRC16_IBM_REF_BE, 16)));
+    c.push_back(crc("CRC16", "CRC-16/CCITT (poly 0x1021)", 0x1021, "LE", 256 * 2, bytes(CRC16_CCITT_REF_LE, 16)));
+    c.push_back(crc("CRC16", "CRC-16/CCITT (poly 0x1021)", 0x1021, "BE", 256 * 2, bytes(CRC16_CCITT_REF_BE, 16)));
+    c.push_back(crc("CRC8", "CRC-8 (poly 0x07)", 0x07, "byte-array", 256, bytes(CRC8_POLY07_REF, 16)));
+    // CRC-64/XZ (ECMA-182 reflected): table[0] = 0, table[1] = 0xB32E4CBE03A75F6F
+    c.push_back(crc("CRC64", "CRC-64/ECMA-182 (poly 0x42F0E1EBA9EA3693)", 0x42F0E1EBA9EA3693ULL, "LE", 256 * 8,
+                    words64({0, 0xB32E4CBE03A75F6FULL}, false)));
+    c.push_back(crc("CRC64", "CRC-64/ECMA-182 (poly 0x42F0E1EBA9EA3693)", 0x42F0E1EBA9EA3693ULL, "BE", 256 * 8,
+                    words64({0, 0xB32E4CBE03A75F6FULL}, true)));
+
+    c.push_back(aes("AES S-box", 256, AES_SBOX));
+    c.push_back(aes("AES inverse S-box", 256, AES_INV_SBOX));
+    c.push_back(aes("AES Rcon", 256, AES_RCON));
+    c.push_back(aes("AES Te0", 1024, AES_TE0_LE, "LE"));
+    c.push_back(aes("AES Te0", 1024, AES_TE0_BE, "BE"));
+    c.push_back(aes("AES Te1", 1024, AES_TE1_LE, "LE"));
+    c.push_back(aes("AES Te1", 1024, AES_TE1_BE, "BE"));
+    c.push_back(aes("AES Te2", 1024, AES_TE2_LE, "LE"));
+    c.push_back(aes("AES Te2", 1024, AES_TE2_BE, "BE"));
+    c.push_back(aes("AES Te3", 1024, AES_TE3_LE, "LE"));
+    c.push_back(aes("AES Te3", 1024, AES_TE3_BE, "BE"));
+    c.push_back(aes("AES Td0", 1024, AES_TD0_LE, "LE"));
+    c.push_back(aes("AES Td0", 1024, AES_TD0_BE, "BE"));
+    c.push_back(aes("AES Td1", 1024, AES_TD1_LE, "LE"));
+    c.push_back(aes("AES Td1", 1024, AES_TD1_BE, "BE"));
+    c.push_back(aes("AES Td2", 1024, AES_TD2_LE, "LE"));
+    c.push_back(aes("AES Td2", 1024, AES_TD2_BE, "BE"));
+    c.push_back(aes("AES Td3", 1024, AES_TD3_LE, "LE"));
+    c.push_back(aes("AES Td3", 1024, AES_TD3_BE, "BE"));
+
+    for (bool be : {false, true}) {
+        const char* order = be ? "BE" : "LE";
+        c.push_back(other("SHA-256 round constants K", order, 64 * 4,
+                          words32({0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5}, be)));
+        c.push_back(other("SHA-1 initial hash value", order, 5 * 4,
+                          words32({0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0}, be)));
+        c.push_back(other("MD5 sine table T", order, 64 * 4,
+                          words32({0xD76AA478, 0xE8C7B756, 0x242070DB, 0xC1BDCEEE}, be)));
+        c.push_back(other("Blowfish P-array", order, 18 * 4,
+                          words32({0x243F6A88, 0x85A308D3, 0x13198A2E, 0x03707344}, be)));
+    }
+    static const uint8_t DES_S1[16] = {14, 4, 13, 1, 2, 15, 11, 8, 3, 10, 6, 12, 5, 9, 0, 7};
+    c.push_back(other("DES S-boxes", "byte per entry", 8 * 64, bytes(DES_S1, 16)));
+    static const char SIGMA[] = "expand 32-byte k";
+    static const char TAU[] = "expand 16-byte k";
+    c.push_back(other("ChaCha/Salsa20 sigma constant", "", 16, bytes(reinterpret_cast<const uint8_t*>(SIGMA), 16)));
+    c.push_back(other("ChaCha/Salsa20 tau constant", "", 16, bytes(reinterpret_cast<const uint8_t*>(TAU), 16)));
+
+    return c;
+}
+
+} // namespace
+
+const std::vector<CryptoConstant>& cryptoConstants() {
+    static const std::vector<CryptoConstant> constants = buildConstants();
+    return constants;
+}
+
+uint32_t cryptoSignatureFamily(const std::string& family) {
+    static const bool registered = [] {
+        SignatureSet& set = SignatureSet::instance();
+        const auto& all = cryptoConstants();
+        for (size_t i = 0; i < all.size(); ++i) {
+            set.add(set.family(all[i].family), all[i].signature.data(), all[i].signature.size(),
+                    static_cast<uint32_t>(i));
+        }
+        return true;
+    }();
+    (void)registered;
+    return SignatureSet::instance().family(family);
+}
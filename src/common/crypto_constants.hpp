@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Well-known tables and constants found in code that implements checksums
+// and ciphers. Each entry is recognised by the first bytes of the table as
+// it is laid out in memory; `family` names the parser that reports it.
+struct CryptoConstant {
+    std::string family;     // "CRC", "AES" or "CRYPTO"
+    std::string info;       // text of the result's info field
+    size_t tableBytes;      // size of the whole table, the result's length
+    std::vector<uint8_t> signature;
+};
+
+const std::vector<CryptoConstant>& cryptoConstants();
+
+// Registers every constant with the shared SignatureSet (once) and returns
+// the signature family id for `family`.
+uint32_t cryptoSignatureFamily(const std::string& family);
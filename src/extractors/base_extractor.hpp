@@ -1,19 +1,36 @@
 #pragma once
+#include "byte_view.hpp"
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <utility>
 
 #include <filesystem>
 namespace fs = std::filesystem;
 
+// Decoded outputs up to this size are also kept in memory for the nested
+// scan, larger ones are scanned from the written file
+constexpr size_t MAX_MEMORY_ARTIFACT = size_t(256) << 20;
+
 
 class BaseExtractor {
 public:
     virtual ~BaseExtractor() = default;
     virtual std::string name() const = 0;
-    virtual void extract(const std::vector<std::uint8_t>& blob, size_t offset,fs::path extractionPath) = 0;
-    virtual void extract(const std::vector<std::uint8_t>& blob, size_t offset,fs::path extractionPath,const std::string& extension)
+    virtual void extract(const ByteView& blob, size_t offset,fs::path extractionPath) = 0;
+    virtual void extract(const ByteView& blob, size_t offset,fs::path extractionPath,const std::string& extension)
     {
         extract(blob,offset,extractionPath);
     }
+
+    // Files written by the last extract() whose bytes are still in memory,
+    // by path. The scanner scans these buffers instead of reading the files
+    // back; extractors that do not keep their output return none.
+    std::vector<std::pair<fs::path, std::vector<uint8_t>>> takeArtifacts()
+    {
+        return std::exchange(artifacts, {});
+    }
+
+protected:
+    std::vector<std::pair<fs::path, std::vector<uint8_t>>> artifacts;
 };
\ No newline at end of file
@@ -0,0 +1,16 @@
+// builtin_extractors.hpp
+#pragma once
+
+// The extractors shipped with hexdig, in registration order
+#define HEXDIG_BUILTIN_EXTRACTORS(X) \
+    X(Bzip2Extractor) \
+    X(CPIOExtractor) \
+    X(CramFSExtractor) \
+    X(DTBExtractor) \
+    X(GZIPExtractor) \
+    X(RawExtractor) \
+    X(RomfsExtractor) \
+    X(SevenZipExtractor) \
+    X(SquashFSExtractor) \
+    X(TARExtractor) \
+    X(UImageExtractor)
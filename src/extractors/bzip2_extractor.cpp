@@ -0,0 +1,72 @@
+#include "base_extractor.hpp"
+#include "extractor_registration.hpp"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <string>
+#include "helpers.hpp"
+#include "logger.hpp"
+#include "bzip2.hpp"
+#include "thread_pool.hpp"
+#include "budget.hpp"
+
+namespace fs = std::filesystem;
+
+// In-process bzip2 decompression; blocks are decoded in parallel on the
+// shared pool and written to decompressed.bin in stream order. The output
+// is also kept in memory for the nested scan, up to MAX_MEMORY_ARTIFACT.
+class Bzip2Extractor : public BaseExtractor {
+public:
+    std::string name() const override { return "BZIP2"; }
+
+    void extract(const ByteView& blob,
+                 size_t offset,
+                 fs::path extractionPath) override
+    {
+        if (offset >= blob.size()) {
+            Logger::error("BZIP2 Offset beyond blob size");
+            return;
+        }
+        extractionPath = extractionPath / fs::path(to_hex(offset));
+        fs::create_directories(extractionPath);
+
+        fs::path outPath = extractionPath / fs::path("decompressed.bin");
+        std::ofstream f(outPath, std::ios::binary);
+        if (!f) {
+            Logger::error("BZIP2 Cannot open output file: " + extractionPath.string());
+            return;
+        }
+
+        size_t written = 0;
+        std::vector<uint8_t> kept;
+        bool keep = true;
+        bool ok = bzip2_decompress(blob.data(), blob.size(), offset,
+            [&](const uint8_t* data, size_t len) {
+                if (written + len > MAX_ANALYZED_FILE_SIZE) {
+                    Logger::error("BZIP2 Output too big, truncated");
+                    return false;
+                }
+                f.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(len));
+                written += len;
+                keep = keep && written <= MAX_MEMORY_ARTIFACT;
+                if (keep)
+                    kept.insert(kept.end(), data, data + len);
+                else
+                    std::vector<uint8_t>().swap(kept);
+                if (!budgetCharge(len)) {
+                    Logger::error("BZIP2 Output over budget, truncated");
+                    return false;
+                }
+                return static_cast<bool>(f);
+            },
+            &ThreadPool::shared());
+        if (!ok)
+            Logger::error("BZIP2 Corrupt or truncated stream at " + to_hex(offset));
+        // The file holds what was decoded even when the stream broke off, so
+        // does the buffer
+        if (keep && f.flush())
+            artifacts.emplace_back(outPath, std::move(kept));
+    }
+};
+
+REGISTER_EXTRACTOR(Bzip2Extractor)
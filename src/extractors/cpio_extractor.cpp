@@ -31,7 +31,7 @@ uint32_t parse_hex(const char* data, size_t len) {
     return std::stoul(hex, nullptr, 16);
 }
 
-CpioHeader read_header(const std::vector<uint8_t>& blob, size_t& offset) {
+CpioHeader read_header(const ByteView& blob, size_t& offset) {
     if (offset + 110 > blob.size()) throw std::runtime_error("Unexpected end of blob");
 
     CpioHeader hdr;
@@ -58,7 +58,7 @@ CpioHeader read_header(const std::vector<uint8_t>& blob, size_t& offset) {
 
 
 
-void extract(const std::vector<uint8_t>& blob,
+void extract(const ByteView& blob,
                             size_t offset,
                             fs::path extractionPath) {
    
@@ -18,7 +18,7 @@ class CramFSExtractor : public BaseExtractor {
 public:
     std::string name() const override { return "CramFS"; }
 
-    void extract(const std::vector<std::uint8_t>& blob,
+    void extract(const ByteView& blob,
                  size_t offset,
                  fs::path extractionPath) override;
 };
@@ -41,7 +41,7 @@ static std::vector<uint8_t> decompressBlock(const uint8_t* data, size_t len) {
     return out;
 }
 
-static void extractInode(const std::vector<uint8_t>& blob, size_t base, bool le,
+static void extractInode(const ByteView& blob, size_t base, bool le,
                          const CramfsInode& ino, const std::string& name,
                          const fs::path& outDir) {
     if (isDir(ino.mode)) {
@@ -75,7 +75,7 @@ static void extractInode(const std::vector<uint8_t>& blob, size_t base, bool le,
     }
 }
 
-void CramFSExtractor::extract(const std::vector<std::uint8_t>& blob,
+void CramFSExtractor::extract(const ByteView& blob,
                               size_t offset,
                               fs::path extractionPath) {
     extractionPath = extractionPath /fs::path(to_hex(offset)); 
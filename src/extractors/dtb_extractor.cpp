@@ -13,7 +13,7 @@ namespace fs = std::filesystem;
 
 
 
-static std::string format_value(const std::vector<uint8_t>& val) {
+static std::string format_value(const ByteView& val) {
     if (val.empty()) return "<empty>";
 
     // Check if printable string(s)
@@ -60,7 +60,7 @@ class DTBExtractor : public BaseExtractor {
 public:
 std::string name() const override { return "DTB"; };
 
-void extract(const std::vector<uint8_t>& blob,
+void extract(const ByteView& blob,
                            size_t offset,fs::path extractionPath) {
 
     if (offset + sizeof(FdtHeader) > blob.size()) return;
@@ -2,14 +2,11 @@
 #pragma once
 #include "extractor_registry.hpp"
 
+// Defines the registration function of a built-in extractor, called from
+// the list in builtin_extractors.hpp (see parser_registration.hpp).
 #define REGISTER_EXTRACTOR(CLASSNAME) \
-    namespace { \
-        struct CLASSNAME##_AutoRegister { \
-            CLASSNAME##_AutoRegister() { \
-                ExtractorRegistry::instance().registerExtractor([]() { \
-                    return std::make_unique<CLASSNAME>(); \
-                }); \
-            } \
-        }; \
-        static CLASSNAME##_AutoRegister global_##CLASSNAME##_AutoRegister; \
+    void registerExtractor_##CLASSNAME(ExtractorRegistry& registry) { \
+        registry.registerExtractor([]() { \
+            return std::make_unique<CLASSNAME>(); \
+        }); \
     }
@@ -0,0 +1,12 @@
+#include "extractor_registry.hpp"
+#include "builtin_extractors.hpp"
+
+#define DECLARE_EXTRACTOR_REGISTRATION(CLASSNAME) void registerExtractor_##CLASSNAME(ExtractorRegistry& registry);
+HEXDIG_BUILTIN_EXTRACTORS(DECLARE_EXTRACTOR_REGISTRATION)
+
+ExtractorRegistry ExtractorRegistry::builtins() {
+    ExtractorRegistry registry;
+#define CALL_EXTRACTOR_REGISTRATION(CLASSNAME) registerExtractor_##CLASSNAME(registry);
+    HEXDIG_BUILTIN_EXTRACTORS(CALL_EXTRACTOR_REGISTRATION)
+    return registry;
+}
@@ -9,11 +9,15 @@ class ExtractorRegistry {
 public:
     using Creator = std::function<std::unique_ptr<BaseExtractor>()>;
 
+    // Process-wide registry, filled with the built-in extractors on first use
     static ExtractorRegistry& instance() {
-        static ExtractorRegistry registry;
+        static ExtractorRegistry registry = builtins();
         return registry;
     }
 
+    // A registry holding the built-in extractors
+    static ExtractorRegistry builtins();
+
     void registerExtractor(Creator creator) {
         creators.push_back(std::move(creator));
     }
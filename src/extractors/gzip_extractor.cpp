@@ -8,6 +8,7 @@
 #include <string>
 #include "helpers.hpp"
 #include "logger.hpp"
+#include "budget.hpp"
 
 namespace fs = std::filesystem;
 
@@ -15,7 +16,7 @@ class GZIPExtractor : public BaseExtractor {
 public:
     std::string name() const override { return "GZIP"; }
 
-    void extract(const std::vector<std::uint8_t>& blob,
+    void extract(const ByteView& blob,
                  size_t offset,
                  fs::path extractionPath) override
     {
@@ -53,6 +54,10 @@ public:
 
             size_t have = buffer.size() - strm.avail_out;
             out.insert(out.end(), buffer.begin(), buffer.begin() + have);
+            if (!budgetCharge(have)) {
+                Logger::error("GZIP Output over budget, truncated");
+                break;
+            }
 
         } while (ret != Z_STREAM_END);
 
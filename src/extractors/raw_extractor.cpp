@@ -14,12 +14,12 @@ public:
         return "RAW";
     }
 
-    void extract(const std::vector<std::uint8_t>& blob, size_t offset, fs::path extractionPath) override 
+    void extract(const ByteView& blob, size_t offset, fs::path extractionPath) override 
     { 
         extractInternal(blob, offset, extractionPath, ".bin");
     } 
     // Overload for raw formats (4 parameters) 
-    void extract(const std::vector<std::uint8_t>& blob, size_t offset, fs::path extractionPath, const std::string& extension) 
+    void extract(const ByteView& blob, size_t offset, fs::path extractionPath, const std::string& extension) 
     { 
         std::string ext = extension; 
         if (!ext.empty() && ext[0] != '.') 
@@ -27,7 +27,7 @@ public:
         extractInternal(blob, offset, extractionPath, ext); 
     }
 private:
-    void extractInternal(const std::vector<std::uint8_t>& blob,
+    void extractInternal(const ByteView& blob,
                  size_t offset,
                  fs::path extractionPath,
                  const std::string& extension) 
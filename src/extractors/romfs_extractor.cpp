@@ -30,7 +30,7 @@ public:
     std::string name() const override { return "ROMFS"; }
 
     // Binwalk-style: writes to disk under outDir; also returns metadata
-    void extract(const std::vector<uint8_t>& blob, size_t offset, fs::path extractionPath) {
+    void extract(const ByteView& blob, size_t offset, fs::path extractionPath) {
         extractionPath = extractionPath /fs::path(to_hex(offset)); 
 
         fs::create_directories(extractionPath);
@@ -116,7 +116,7 @@ public:
     }
 
 private:
-    RomfsEntry readEntry(const std::vector<uint8_t>& blob, size_t base, size_t fsEnd, size_t hdrOff) {
+    RomfsEntry readEntry(const ByteView& blob, size_t base, size_t fsEnd, size_t hdrOff) {
         RomfsEntry e{};
         e.headerOffset = hdrOff;
         e.next     = read_be32(blob, hdrOff + 0);
@@ -153,7 +153,7 @@ private:
         e.type = RomfsEntry::Symlink; // binwalk-like tolerance
     }
 
-    void enumerateChildren(const std::vector<uint8_t>& blob,
+    void enumerateChildren(const ByteView& blob,
                            size_t base, size_t fsEnd, uint32_t childOff,
                            const fs::path& parent,
                            std::set<size_t>& visited,
@@ -205,7 +205,7 @@ private:
         }
     }
 
-    static void writeFile(const fs::path& path, const std::vector<uint8_t>& blob, size_t off, size_t len) {
+    static void writeFile(const fs::path& path, const ByteView& blob, size_t off, size_t len) {
         std::ofstream f(path, std::ios::binary);
         f.write(reinterpret_cast<const char*>(&blob[off]), static_cast<std::streamsize>(len));
     }
@@ -223,7 +223,7 @@ private:
         return os.str();
     }
 
-    static std::string readNullTermString(const std::vector<uint8_t>& blob, size_t start, size_t limit) {
+    static std::string readNullTermString(const ByteView& blob, size_t start, size_t limit) {
         std::string s;
         for (size_t i = start; i < limit; ++i) {
             uint8_t c = blob[i];
@@ -236,7 +236,7 @@ private:
     // Conservative, binwalk-like checksum acceptance: if checksum field matches
     // a simple additive sum of all BE 32-bit words in the filesystem region.
     // If your ROMFS uses the "sum of superblock words equals 0" rule, we can switch to that.
-    static bool validateFilesystemChecksum(const std::vector<uint8_t>& blob, size_t base, size_t fsSize, uint32_t sbChecksum) {
+    static bool validateFilesystemChecksum(const ByteView& blob, size_t base, size_t fsSize, uint32_t sbChecksum) {
         uint64_t sum = 0;
         for (size_t off = base; off + 4 <= base + fsSize; off += 4) {
             sum += read_be32(blob, off);
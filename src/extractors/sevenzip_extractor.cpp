@@ -8,6 +8,7 @@
 #include <cstring>
 #include "helpers.hpp"
 #include "logger.hpp"
+#include "budget.hpp"
 namespace fs = std::filesystem;
 
 
@@ -16,7 +17,7 @@ class SevenZipExtractor : public BaseExtractor {
 public:
 std::string name() const override { return "7Z"; };
 
-void extract(const std::vector<uint8_t>& blob,
+void extract(const ByteView& blob,
                             size_t offset,
                             fs::path extractionPath) {
    
@@ -42,6 +43,13 @@ void extract(const std::vector<uint8_t>& blob,
             Logger::error("SevenZipExtractor: File too big to decompress");
             return;
         }
+        // 7z runs as a separate process and cannot be stopped halfway;
+        // what it writes is charged by the scanner once it is done
+        if (!budgetOk())
+        {
+            Logger::error("SevenZipExtractor: Budget exceeded, not extracted");
+            return;
+        }
 
         out.write(reinterpret_cast<const char*>(&blob[offset]), dumpSize);
         out.close();
@@ -10,7 +10,7 @@ namespace fs = std::filesystem;
 class SquashFSExtractor : public BaseExtractor {
 public:
     std::string name() const override { return "SquashFS"; };
-    void extract(const std::vector<uint8_t>& blob, size_t offset, fs::path extractionPath) override {
+    void extract(const ByteView& blob, size_t offset, fs::path extractionPath) override {
 
         extractionPath = extractionPath /fs::path(to_hex(offset)); 
 
@@ -15,7 +15,7 @@ namespace fs = std::filesystem;
 
 class TARExtractor : public BaseExtractor {
 public:
-    void extract(const std::vector<uint8_t>& blob,
+    void extract(const ByteView& blob,
                  size_t offset,
                  fs::path extractionPath) override;
 
@@ -60,7 +60,7 @@ static std::string sanitize_path(const std::string& raw) {
     return safe.string();
 }
 
-void TARExtractor::extract(const std::vector<uint8_t>& blob,
+void TARExtractor::extract(const ByteView& blob,
                            size_t offset,
                            fs::path extractionPath) {
     if (offset + 512 > blob.size()) return;
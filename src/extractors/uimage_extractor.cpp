@@ -12,7 +12,7 @@ class UImageExtractor : public BaseExtractor {
 public:
 std::string name() const override { return "UIMAGE"; };
 
-void extract(const std::vector<uint8_t>& blob,
+void extract(const ByteView& blob,
                               size_t offset,
                               fs::path extractionPath) {
     if (offset + 8 > blob.size()) return;
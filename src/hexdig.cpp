@@ -0,0 +1,50 @@
+#include "hexdig.hpp"
+#include "scanner.hpp"
+#include "parser_registry.hpp"
+#include "file_reader.hpp"
+#include "logger.hpp"
+
+namespace hexdig {
+
+namespace {
+
+class CallbackSink : public ResultSink {
+public:
+    explicit CallbackSink(const ResultCallback& callback) : callback(callback) {}
+    void onResult(const ResultView& result) override { callback(result); }
+
+private:
+    const ResultCallback& callback;
+};
+
+} // namespace
+
+ResultStore scan(ByteView data, const std::string& name,
+                 const ScanOptions& options, const ResultCallback& onResult) {
+    Scanner scanner(false, 0, 0, "extractions/", options.verbose);
+    scanner.skipHighEntropy = options.skipHighEntropy;
+    scanner.blockAlignment = options.blockAlignment;
+    scanner.cache = options.cache;
+    scanner.budgets = &options.budgets;
+    scanner.profile = options.profile;
+    CallbackSink sink(onResult);
+    if (onResult)
+        scanner.addSink(&sink);
+    return scanner.scanBuffer(data, name);
+}
+
+ResultStore scanFile(const std::string& path, const ScanOptions& options,
+                     const ResultCallback& onResult) {
+    MappedFile file;
+    if (!file.open(path)) {
+        Logger::error("Error: Cannot open file " + path);
+        return {};
+    }
+    return scan(file.view(), path, options, onResult);
+}
+
+void registerParser(std::function<std::unique_ptr<BaseParser>()> factory) {
+    ParserRegistry::instance().registerParser(std::move(factory));
+}
+
+} // namespace hexdig
@@ -0,0 +1,47 @@
+#pragma once
+// Embedding API of libhexdig: scan bytes held by the application, in
+// process and without copying them. Link against the libhexdig target.
+#include "scanresult.hpp"
+#include "result_store.hpp"
+#include "byte_view.hpp"
+#include "base_parser.hpp"
+#include "budget.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ScanCache;
+class ParserProfile;
+
+namespace hexdig {
+
+struct ScanOptions {
+    bool verbose = false;          // also report padding and whole-input matches
+    bool skipHighEntropy = false;  // see --skip-entropy
+    size_t blockAlignment = 0;     // see --align
+    ScanCache* cache = nullptr;    // optional, may be shared between threads
+    BudgetConfig budgets;          // time and byte limits, see --budget
+    ParserProfile* profile = nullptr;  // optional probe counters, also order the probes
+};
+
+// Receives every top-level result as soon as it is complete; the view and
+// its children are valid until the scan returns (ResultView::toResult
+// copies a result)
+using ResultCallback = std::function<void(const ResultView&)>;
+
+// Scans `data` in place. Results go to `onResult` while the scan runs and
+// are returned at the end. Scans are independent and may run concurrently.
+// Nothing is extracted.
+ResultStore scan(ByteView data, const std::string& name = "<buffer>",
+                 const ScanOptions& options = {}, const ResultCallback& onResult = nullptr);
+
+// Same for a file, memory-mapped read-only
+ResultStore scanFile(const std::string& path, const ScanOptions& options = {},
+                     const ResultCallback& onResult = nullptr);
+
+// Adds a parser after the built-in ones; scans create one instance each.
+// Register before the first scan.
+void registerParser(std::function<std::unique_ptr<BaseParser>()> factory);
+
+} // namespace hexdig
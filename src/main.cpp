@@ -7,11 +7,24 @@
 #include <unordered_set>
 #include <vector>
 #include <fstream>
+#include <cstdio>
+#include <algorithm>
 #include "logger.hpp"
 #include <chrono>
 #include "utils/printer.hpp"
+#include "utils/scan_index.hpp"
+#include "utils/entropy.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/stream_input.hpp"
+#include "utils/input_transform.hpp"
+#include "scan_server.hpp"
 
 namespace fs = std::filesystem;
+
+// --fast-triage alignment: the sector size, which filesystems and
+// partitions in flash and eMMC dumps are always aligned to
+static constexpr size_t FAST_TRIAGE_ALIGN = 512;
+
 struct Config {
     bool extract = false;
     int recurseDepth = 0;
@@ -20,6 +33,29 @@ struct Config {
     bool verbose = false;
     std::string extractionPath = "extractions/";
     std::string inputFile;
+    std::vector<std::string> inputs;  // all files to scan, see collectInputs
+    bool batch = false;        // several inputs, a directory or an @list
+    size_t jobs = 0;           // --jobs: parallel scans in batch mode, 0 = one per CPU
+    std::string serveSocket;   // --serve: run as a scan daemon on this Unix socket
+    std::string submitSocket;  // --submit: send the inputs to a daemon
+    size_t maxQueue = DEFAULT_SERVER_QUEUE;          // --max-queue: daemon admission limit
+    uint64_t maxJobSize = DEFAULT_SERVER_MAX_JOB;    // --max-job-size: daemon per-job input limit
+    unsigned inputTimeout = DEFAULT_SERVER_INPUT_TIMEOUT_S;  // --input-timeout: daemon per-job read limit
+    std::string indexFile;     // -B: binary scan index output
+    std::string readIndexFile; // --read-index: print an existing index
+    std::string queryType;     // --query: only list records of this type
+    std::string cacheDir;      // --cache: on-disk scan cache directory
+    bool cacheSha256 = false;  // --sha256: key the cache by SHA-256
+    bool entropy = false;      // -E: entropy analysis instead of a signature scan
+    std::string entropyFile;   // --entropy-out: per-block series as CSV or JSON
+    size_t blockSize = 1024;   // --block-size: entropy block size in bytes
+    bool skipEntropy = false;  // --skip-entropy: skip text/header parsers in high-entropy data
+    size_t align = 0;          // --align: run filesystem/partition parsers only at multiples of N
+    bool stream = false;       // --stream: bounded-memory scan, also used for stdin and devices
+    std::string transform;     // --transform: input transformer, implies --stream unless "raw"
+    BudgetConfig budgets;      // --budget: time and byte limits of scans, parsers and extractors
+    bool profile = false;      // --profile: print per-parser probe counters at the end
+    std::string statsFile;     // --parser-stats: probe counters kept between runs, order the probes
 };
 
 
@@ -73,6 +109,46 @@ public:
 };
 
 
+// Expands the positional arguments into the files to scan: directories are
+// walked recursively and "@file" reads one path per line ('#' comments).
+// More than one input, a directory or a list selects batch mode.
+static std::vector<std::string> collectInputs(const std::vector<std::string>& args, bool& batch) {
+    std::vector<std::string> inputs;
+    batch = args.size() > 1;
+    for (const auto& arg : args) {
+        std::error_code ec;
+        if (arg.size() > 1 && arg[0] == '@') {
+            batch = true;
+            std::ifstream list(arg.substr(1));
+            if (!list) {
+                Logger::error("Error: Cannot open input list " + arg.substr(1));
+                continue;
+            }
+            std::string line;
+            while (std::getline(list, line)) {
+                while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+                    line.pop_back();
+                if (!line.empty() && line[0] != '#')
+                    inputs.push_back(line);
+            }
+        } else if (fs::is_directory(arg, ec)) {
+            batch = true;
+            std::vector<std::string> files;
+            fs::recursive_directory_iterator it(arg, fs::directory_options::skip_permission_denied, ec), end;
+            for (; it != end; it.increment(ec)) {
+                if (ec)
+                    break;
+                if (it->is_regular_file(ec))
+                    files.push_back(it->path().string());
+            }
+            std::sort(files.begin(), files.end());
+            inputs.insert(inputs.end(), files.begin(), files.end());
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    return inputs;
+}
 
 Config parseArgs(int argc, char* argv[]) {
 
@@ -102,6 +178,34 @@ Config parseArgs(int argc, char* argv[]) {
     args.addOption("-r", true, "recurse"); 
     args.addOption("--recurse", true, "recurse");
 
+    args.addOption("-B", true, "binaryIndex"); 
+    args.addOption("--binaryIndex", true, "binaryIndex");
+
+    args.addOption("--cache", true, "cache");
+    args.addOption("--sha256", false, "sha256");
+
+    args.addOption("-E", false, "entropy");
+    args.addOption("--entropy", false, "entropy");
+    args.addOption("--entropy-out", true, "entropyOut");
+    args.addOption("--block-size", true, "blockSize");
+    args.addOption("--skip-entropy", false, "skipEntropy");
+    args.addOption("--align", true, "align");
+    args.addOption("--fast-triage", false, "fastTriage");
+    args.addOption("--stream", false, "stream");
+    args.addOption("--transform", true, "transform");
+    args.addOption("--jobs", true, "jobs");
+    args.addOption("--serve", true, "serve");
+    args.addOption("--submit", true, "submit");
+    args.addOption("--max-queue", true, "maxQueue");
+    args.addOption("--max-job-size", true, "maxJobSize");
+    args.addOption("--input-timeout", true, "inputTimeout");
+    args.addOption("--budget", true, "budget");
+    args.addOption("--profile", false, "profile");
+    args.addOption("--parser-stats", true, "parserStats");
+
+    args.addOption("--read-index", true, "readIndex");
+    args.addOption("--query", true, "query");
+
     args.parse(argc,argv);
 
     
@@ -158,45 +262,434 @@ Config parseArgs(int argc, char* argv[]) {
         Logger::debug("Setting json output path to "+ config.jsonFile);
     }
 
+    if(args.has("binaryIndex"))
+    {
+        config.indexFile = args.get("binaryIndex");
+        Logger::debug("Setting binary index output path to "+ config.indexFile);
+    }
+
+    if(args.has("cache"))
+    {
+        config.cacheDir = args.get("cache");
+        config.cacheSha256 = args.has("sha256");
+        Logger::debug("Using scan cache in "+ config.cacheDir);
+    }
+
+    if(args.has("entropy") || args.has("entropyOut"))
+    {
+        config.entropy = true;
+        config.entropyFile = args.get("entropyOut");
+    }
+
+    if(args.has("blockSize"))
+    {
+        long long bs = std::stoll(args.get("blockSize"));
+        config.blockSize = bs > 0 ? static_cast<size_t>(bs) : 1024;
+        Logger::debug("Setting entropy block size to "+ std::to_string(config.blockSize));
+    }
+
+    if(args.has("skipEntropy"))
+    {
+        Logger::debug("Skipping structure-dependent parsers in high-entropy regions");
+        config.skipEntropy = true;
+    }
+
+    if(args.has("fastTriage"))
+    {
+        Logger::debug("Fast triage: sector-aligned filesystem parsers, high-entropy skipping");
+        config.align = FAST_TRIAGE_ALIGN;
+        config.skipEntropy = true;
+    }
+
+    if(args.has("align"))
+    {
+        long long align = std::stoll(args.get("align"));
+        config.align = align > 1 ? static_cast<size_t>(align) : 0;
+        Logger::debug("Setting block alignment to "+ std::to_string(config.align));
+    }
+
+    if(args.has("stream"))
+    {
+        Logger::debug("Streaming scan");
+        config.stream = true;
+    }
+
+    if(args.has("transform"))
+    {
+        config.transform = args.get("transform");
+        Logger::debug("Input transform " + config.transform);
+        if (config.transform != "raw")
+            config.stream = true;
+    }
+
+    if(args.has("jobs"))
+    {
+        long long jobs = std::stoll(args.get("jobs"));
+        config.jobs = jobs > 0 ? static_cast<size_t>(jobs) : 0;
+        Logger::debug("Batch scans on "+ std::to_string(config.jobs) + " threads");
+    }
+
+    if(args.has("maxQueue"))
+    {
+        long long queue = std::stoll(args.get("maxQueue"));
+        config.maxQueue = queue > 0 ? static_cast<size_t>(queue) : 1;
+    }
+
+    if(args.has("maxJobSize"))
+    {
+        long long size = std::stoll(args.get("maxJobSize"));
+        config.maxJobSize = size > 0 ? static_cast<uint64_t>(size) : DEFAULT_SERVER_MAX_JOB;
+    }
+
+    if(args.has("inputTimeout"))
+    {
+        long long seconds = std::stoll(args.get("inputTimeout"));
+        config.inputTimeout = seconds > 0 ? static_cast<unsigned>(seconds) : DEFAULT_SERVER_INPUT_TIMEOUT_S;
+    }
+
+    if(args.has("budget"))
+    {
+        if (!parseBudgets(args.get("budget"), config.budgets))
+            std::exit(1);
+        Logger::debug("Budgets " + args.get("budget"));
+    }
+
+    if(args.has("profile"))
+    {
+        config.profile = true;
+    }
+
+    if(args.has("parserStats"))
+    {
+        config.statsFile = args.get("parserStats");
+        Logger::debug("Parser stats in " + config.statsFile);
+    }
+
+    if(args.has("serve"))
+    {
+        config.serveSocket = args.get("serve");
+        return config;
+    }
+
+    if(args.has("submit"))
+    {
+        config.submitSocket = args.get("submit");
+    }
+
+    if(args.has("readIndex"))
+    {
+        config.readIndexFile = args.get("readIndex");
+        config.queryType = args.get("query");
+        return config;
+    }
+
     if(args.has("help") || args.positional.empty())
     {
-        std::cout << "Usage: scanner [-e] [-r N or -rN] [-j [file]] <input_file>\n"
+        std::cout << "Usage: scanner [-e] [-r N or -rN] [-j [file]] <input_file|dir|@list>...\n"
+                  << "       scanner --read-index <file.hdx> [--query TYPE]\n"
+                  << "       scanner --serve <socket> | --submit <socket> <input_file>...\n"
                       << "  -e         Enable extraction\n"
                       << "  -r N       Enable recursive scan with depth N (default 1)\n"
                       << "  -M         Matrioshka scan (recurse 10 times) \n"
                       << "  -O [file]  Output in JSON format, optionally to given file\n"
+                      << "  -B [file]  Write a binary scan index (.hdx) to file\n"
                       << "  -C [path]  Custom extraction path\n"
                       << "  -d         Enable Debug mode\n"
                       << "  -v         Verbose output\n"
-                      << "  -h         Show this help message\n";
+                      << "  -h         Show this help message\n"
+                      << "  -E         Entropy analysis: print high/low-entropy regions\n"
+                      << "  --entropy-out [file] Write per-block entropy as CSV, or JSON for *.json\n"
+                      << "  --block-size N       Entropy block size in bytes (default 1024)\n"
+                      << "  --skip-entropy       Skip TAR/CPIO/DTB/COPYRIGHT/SVG in high-entropy regions\n"
+                      << "  --align N            Probe filesystem/partition parsers only at multiples of N\n"
+                      << "  --fast-triage        Same as --align 512 --skip-entropy\n"
+                      << "  --stream             Scan through a bounded window, no extraction; \"-\" reads stdin\n"
+                      << "  --transform T        Decode the input while streaming: android-sparse, nand[:PAGE:OOB], raw\n"
+                      << "  --jobs N             Batch scans: scan N inputs in parallel (default: one per CPU)\n"
+                      << "  --serve [socket]     Run as a scan daemon, NDJSON results per job\n"
+                      << "  --submit [socket]    Scan the inputs through a running daemon\n"
+                      << "  --max-queue N        Daemon: refuse jobs beyond N pending (default 64)\n"
+                      << "  --max-job-size N     Daemon: refuse inputs larger than N bytes (default 1 GiB)\n"
+                      << "  --input-timeout S    Daemon: give up on inputs not read within S seconds (default 60)\n"
+                      << "  --budget SPEC        Limit time and bytes, e.g. scan=60s:1G,parser=2s:256M,extractor.7Z=30s\n"
+                      << "  --profile            Print per-parser probe counts and costs after the scan\n"
+                      << "  --parser-stats [file] Keep probe counters between runs and order probes by them\n"
+                      << "  --cache [dir]        Reuse results of identical blobs from an on-disk cache (not with -e)\n"
+                      << "  --sha256             Key the cache by SHA-256 instead of XXH64\n"
+                      << "  --read-index [file]  Print a binary scan index instead of scanning\n"
+                      << "  --query TYPE         With --read-index, list only records of TYPE\n";
         std::exit(0);
     }
 
  
    
-    config.inputFile = args.positional.back();
+    config.inputs = collectInputs(args.positional, config.batch);
+    config.inputFile = config.inputs.empty() ? args.positional.back() : config.inputs.front();
     
     return config;
 }
 
+// --read-index: print the tree stored in an .hdx file, or with --query list
+// the matching records one per line.
+static int readIndex(const Config& config) {
+    ScanIndexReader index;
+    if (!index.open(config.readIndexFile))
+        return 1;
+
+    if (config.queryType.empty()) {
+        ResultStore results;
+        if (!index.toResults(results))
+            return 1;
+        printScanResults(results, index.string(index.header().inputName));
+        return 0;
+    }
+
+    std::string out;
+    char line[64];
+    for (size_t i = 0; i < index.size(); ++i) {
+        const HdxRecord& rec = index.record(i);
+        if (config.queryType != index.name(rec.typeId))
+            continue;
+        std::snprintf(line, sizeof(line), "0x%llx\t%llu\t",
+                      (unsigned long long)rec.offset, (unsigned long long)rec.length);
+        out += line;
+        out += index.name(rec.typeId);
+        out += '\t';
+        out += index.string(rec.source);
+        out += '\t';
+        out += index.string(rec.info);
+        out += '\n';
+    }
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    return 0;
+}
+
+// -E: stream the input once through the entropy analyzer, print the detected
+// regions and optionally write the per-block series.
+static int entropyMode(const Config& config) {
+    std::ifstream in(config.inputFile, std::ios::binary);
+    if (!in) {
+        Logger::error("Error: Cannot open file " + config.inputFile);
+        return 1;
+    }
+
+    EntropyAnalyzer analyzer(config.blockSize, &ThreadPool::shared());
+    // Whole blocks per read so nothing has to be carried between chunks
+    size_t chunk = std::max<size_t>(1, (size_t(16) << 20) / config.blockSize) * config.blockSize;
+    std::vector<uint8_t> buf(chunk);
+    while (in) {
+        in.read(reinterpret_cast<char*>(buf.data()), static_cast<std::streamsize>(buf.size()));
+        std::streamsize got = in.gcount();
+        if (got <= 0)
+            break;
+        analyzer.update(buf.data(), static_cast<size_t>(got));
+    }
+    EntropyProfile profile = analyzer.finish();
+
+    std::string out;
+    char line[128];
+    std::snprintf(line, sizeof(line), "%-12s %-12s %-6s %s\n", "OFFSET", "LENGTH", "KIND", "ENTROPY");
+    out += line;
+    for (const auto& r : profile.regions) {
+        std::snprintf(line, sizeof(line), "0x%-10llx %-12llu %-6s %.4f\n",
+                      (unsigned long long)r.offset, (unsigned long long)r.length,
+                      r.high ? "high" : "low", r.average);
+        out += line;
+    }
+    std::fwrite(out.data(), 1, out.size(), stdout);
+
+    if (!config.entropyFile.empty() && !writeEntropy(profile, config.entropyFile))
+        return 1;
+    return 0;
+}
+
+// Scans one input with the configured scanner, streaming it when it cannot
+// or should not be loaded into memory.
+static ResultStore scanInput(Scanner& scanner, const Config& config, const std::string& inputFile) {
+    // Pipes, character/block devices and stdin cannot be loaded into memory
+    // as a whole, they are always streamed; so are files with holes unless
+    // something has to be extracted, streaming never reads the holes.
+    // Android sparse images are expanded on the fly while streaming.
+    std::error_code ec;
+    bool stream = config.stream || inputFile == "-" ||
+                  (fs::exists(inputFile, ec) && !fs::is_regular_file(inputFile, ec)) ||
+                  (!config.extract && isSparseFile(inputFile)) ||
+                  (config.transform.empty() && isAndroidSparseImage(inputFile));
+    if (!stream)
+        return scanner.scan(fs::path(inputFile));
+    auto input = openInput(inputFile, config.transform);
+    if (!input)
+        return ResultStore();
+    return scanner.scanStream(*input, inputFile);
+}
+
+static void setupScanner(Scanner& scanner, const Config& config, ScanCache* cache, ParserProfile* profile) {
+    scanner.skipHighEntropy = config.skipEntropy;
+    scanner.blockAlignment = config.align;
+    scanner.cache = cache;
+    scanner.budgets = &config.budgets;
+    scanner.profile = profile;
+}
+
+// Several inputs: every file gets its own scanner on a bounded pool, one
+// process instead of one per file. The largest files are started first so
+// a big image does not end up running alone at the end. Each tree is
+// printed as a whole once its scan is done, in the order of the inputs.
+static int batchMode(const Config& config, ScanCache* cache, ParserProfile* profile) {
+    struct Job {
+        std::string input;
+        uint64_t size = 0;
+        fs::path extractionPath;
+        std::string output;
+        ResultStore results;
+    };
+    std::vector<Job> jobs(config.inputs.size());
+    std::unordered_map<std::string, int> names;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        Job& job = jobs[i];
+        job.input = config.inputs[i];
+        std::error_code ec;
+        job.size = fs::file_size(job.input, ec);
+        if (ec)
+            job.size = 0;
+        // Extractions go to one directory per input, named after the file
+        std::string name = fs::path(job.input).filename().string();
+        int seen = names[name]++;
+        if (seen)
+            name += "_" + std::to_string(seen);
+        job.extractionPath = fs::path(config.extractionPath) / name;
+    }
+
+    std::vector<size_t> order(jobs.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&jobs](size_t a, size_t b) { return jobs[a].size > jobs[b].size; });
+
+    ThreadPool pool(config.jobs);
+    Logger::info("Scanning " + std::to_string(jobs.size()) + " inputs on " +
+                 std::to_string(pool.size()) + " threads");
+    std::vector<std::future<void>> done(jobs.size());
+    for (size_t i : order) {
+        done[i] = pool.submit([&config, cache, profile, &job = jobs[i]] {
+            Scanner scanner(config.extract, config.recurseDepth, 0, job.extractionPath, config.verbose);
+            setupScanner(scanner, config, cache, profile);
+            TreePrinter printer(&job.output);
+            scanner.addSink(&printer);
+            job.results = scanInput(scanner, config, job.input);
+        });
+    }
+
+    std::vector<std::pair<std::string, ResultStore>> all;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        done[i].get();
+        std::fwrite(jobs[i].output.data(), 1, jobs[i].output.size(), stdout);
+        std::fflush(stdout);
+        jobs[i].output.clear();
+        if (config.jsonOutput)
+            all.emplace_back(jobs[i].input, std::move(jobs[i].results));
+    }
+    if (config.jsonOutput)
+        dumpJsonBatch(all, config.jsonFile);
+    if (!config.indexFile.empty())
+        Logger::error("A binary scan index holds a single input, -B is ignored in batch mode");
+    return 0;
+}
+
+// --profile prints the counters, --parser-stats keeps them for the next run
+static void finishProfile(const Config& config, const ParserProfile* profile) {
+    if (!profile)
+        return;
+    if (config.profile)
+        std::cerr << profile->report();
+    if (!config.statsFile.empty())
+        profile->save(config.statsFile);
+}
+
+// --serve: keep the registry and a result cache warm across jobs
+static int serveMode(const Config& config) {
+    ServerOptions options;
+    options.socketPath = config.serveSocket;
+    options.jobs = config.jobs;
+    options.maxQueue = config.maxQueue;
+    options.maxJobSize = config.maxJobSize;
+    options.inputTimeout = config.inputTimeout;
+    options.cacheDir = config.cacheDir;
+    options.cacheSha256 = config.cacheSha256;
+    options.verbose = config.verbose;
+    options.skipHighEntropy = config.skipEntropy;
+    options.blockAlignment = config.align;
+    options.budgets = config.budgets;
+    options.statsFile = config.statsFile;
+    return runScanServer(options);
+}
+
 int main(int argc, char* argv[]) {
     Logger::setLevel(LogLevel::INFO);
     Logger::info("HexDig v0.1");
     
     Config config = parseArgs(argc, argv);
+    if (!config.readIndexFile.empty())
+        return readIndex(config);
+    if (!config.serveSocket.empty())
+        return serveMode(config);
+    if (!config.submitSocket.empty())
+        return submitScanJobs(config.submitSocket, config.inputs);
+    if (config.entropy) {
+        int status = 0;
+        for (const auto& input : config.inputs) {
+            Config single = config;
+            single.inputFile = input;
+            if (config.batch)
+                std::cout << "* " << input << std::endl;
+            status |= entropyMode(single);
+        }
+        return status;
+    }
+
+    std::unique_ptr<ScanCache> cache;
+    if (!config.cacheDir.empty())
+        cache = std::make_unique<ScanCache>(config.cacheDir, config.cacheSha256);
+
+    std::unique_ptr<ParserProfile> profile;
+    if (config.profile || !config.statsFile.empty()) {
+        profile = std::make_unique<ParserProfile>();
+        if (!config.statsFile.empty())
+            profile->load(config.statsFile);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (config.batch) {
+        int status = batchMode(config, cache.get(), profile.get());
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+        Logger::info("Total elapsed time: " + std::to_string(elapsed) + "ms");
+        finishProfile(config, profile.get());
+        return status;
+    }
 
     Scanner scanner(config.extract, config.recurseDepth,0,fs::path(config.extractionPath),config.verbose);
+    setupScanner(scanner, config, cache.get(), profile.get());
+    TreePrinter printer;
+    scanner.addSink(&printer);
     Logger::info("Opening " + config.inputFile + "...");
     
-    auto start = std::chrono::high_resolution_clock::now();
-    auto results = scanner.scan(fs::path(config.inputFile));
-    printScanResults(results,config.inputFile);
+    auto results = scanInput(scanner, config, config.inputFile);
     if(config.jsonOutput)
         dumpJson(results,config.jsonFile);
+    if(!config.indexFile.empty())
+    {
+        std::error_code ec;
+        ScanIndexMeta meta;
+        meta.inputName = config.inputFile;
+        meta.inputSize = fs::file_size(config.inputFile, ec);
+        writeScanIndex(results, meta, config.indexFile);
+    }
 
     auto end = std::chrono::high_resolution_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
     Logger::info("Total elapsed time: " + std::to_string(elapsed) + "ms");
+    finishProfile(config, profile.get());
 
     return 0;
 }
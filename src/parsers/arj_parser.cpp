@@ -1,11 +1,11 @@
 #include "base_parser.hpp"
 #include "parser_registration.hpp"
 #include <string>
-#include <sstream>
 #include <vector>
 #include <cstdint>
 #include <algorithm>
 #include "helpers.hpp"
+#include "checksum.hpp"
 
 
 
@@ -13,8 +13,10 @@
 class ARJParser : public BaseParser {
 public:
     std::string name() const override { return "ARJ"; }
+    std::vector<uint8_t> anchorBytes() const override { return {0x60}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         if (offset + 4 > blob.size()) return false;
 
         // Magic check
@@ -40,7 +42,7 @@ public:
         return true;
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "ARJ";
@@ -90,13 +92,10 @@ public:
         r.length = cursor - offset;
         r.isValid = trailerFound && fileCount > 0;
 
-        std::ostringstream info;
-        info << "ARJ archive, version=" << (int)version
-             << ", flags=0x" << std::hex << (int)flags << std::dec
-             << ", files=" << fileCount
-             << (trailerFound ? ", trailer=OK" : ", trailer=MISSING");
-
-        r.info = info.str();
+        r.info.text("ARJ archive, version=").field("version", version)
+              .text(", flags=0x").field("flags", flags, InfoField::HEX)
+              .text(", files=").field("files", fileCount)
+              .text(", trailer=").field("trailer", trailerFound ? "OK" : "MISSING");
         return r;
     }
 };
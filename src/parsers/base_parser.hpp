@@ -1,16 +1,51 @@
 #pragma once
+#include "byte_view.hpp"
 #include <vector>
 #include <string>
 #include <tuple>
 #include <cstdint>
+#include <optional>
 #include "scanresult.hpp"
 
+class SignatureIndex;
+
+// How freely the scanner may move a parser in the probe order of an offset.
+// Magic parsers check a magic of their own at the offset, two of them never
+// accept the same offset, so they are probed in any order among themselves.
+// Ordered parsers (heuristics, tables, signatures away from the offset,
+// text) may accept where another parser does too; they keep their
+// registration position relative to every other parser, which decides the
+// winner.
+enum class ProbeTier { Magic, Ordered };
 
 class BaseParser {
 public:
     virtual ~BaseParser() = default;
     virtual std::string name() const = 0;
-    virtual bool match(const std::vector<std::uint8_t>& blob, size_t offset) = 0;
-    virtual ScanResult parse(const std::vector<std::uint8_t>& blob, size_t offset) = 0;
+    virtual bool match(const ByteView& blob, size_t offset) = 0;
+    virtual ScanResult parse(const ByteView& blob, size_t offset) = 0;
+    // Formats made of plain-text or mostly-zero headers cannot start inside
+    // compressed or encrypted data; the scanner may skip such parsers there.
+    virtual bool needsStructuredData() const { return false; }
+    // Filesystem and partition headers sit on sector or erase-block
+    // boundaries; with Scanner::blockAlignment set such parsers only run at
+    // aligned offsets.
+    virtual bool blockAligned() const { return false; }
+    // Called once per blob before the scan loop with the blob's signature
+    // hits, for parsers that locate fixed byte patterns through SignatureSet.
+    virtual void prepare(const ByteView&, const SignatureIndex&) {}
+
+    // Cheap prefilter: the byte values a match can start with. The scanner
+    // only probes a parser at offsets holding one of them; empty means any.
+    virtual std::vector<std::uint8_t> anchorBytes() const { return {}; }
+    virtual ProbeTier probeTier() const { return ProbeTier::Ordered; }
+    // Single call used by the scanner: nothing when the signature is not
+    // there, otherwise the parsed result. Parsers whose parse() would redo
+    // match() work override this to decode the header only once.
+    virtual std::optional<ScanResult> probe(const ByteView& blob, size_t offset) {
+        if (!match(blob, offset))
+            return std::nullopt;
+        return parse(blob, offset);
+    }
 
 };
@@ -1,7 +1,6 @@
 #include "base_parser.hpp"
 #include "parser_registration.hpp"
 #include <string>
-#include <sstream>
 #include <vector>
 #include <cstdint>
 #include <algorithm>
@@ -12,13 +11,15 @@
 class BMPParser : public BaseParser {
 public:
     std::string name() const override { return "BMP"; }
+    std::vector<uint8_t> anchorBytes() const override { return {'B'}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         if (offset + 2 > blob.size()) return false;
         return blob[offset] == 'B' && blob[offset+1] == 'M';
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "BMP";
@@ -53,15 +54,14 @@ public:
         r.length = computedLen;
         r.isValid = plausible;
 
-        std::ostringstream info;
-        info << "BMP image, " << width << "x" << height
-             << ", bpp=" << bpp
-             << ", compression=" << comp
-             << ", fileSize=" << fileSize
-             << ", dataOffset=" << dataOffset
-             << ", DIB size=" << dibSize
-             << ", imageSize=" << imgSize;
-        r.info = info.str();
+        r.info.text("BMP image, ").field("width", width, InfoField::SIGNED)
+              .text("x").field("height", height, InfoField::SIGNED)
+              .text(", bpp=").field("bpp", bpp)
+              .text(", compression=").field("compression", comp)
+              .text(", fileSize=").field("file_size", fileSize)
+              .text(", dataOffset=").field("data_offset", dataOffset)
+              .text(", DIB size=").field("dib_size", dibSize)
+              .text(", imageSize=").field("image_size", imgSize);
 
         return r;
     }
@@ -0,0 +1,39 @@
+// builtin_parsers.hpp
+#pragma once
+
+// The parsers shipped with hexdig, in registration order. The order decides
+// which parser wins when several accept the same offset; new parsers go
+// where their source file sorts.
+#define HEXDIG_BUILTIN_PARSERS(X) \
+    X(AESParser) \
+    X(ARJParser) \
+    X(BMPParser) \
+    X(Bzip2Parser) \
+    X(CABParser) \
+    X(CopyrightParser) \
+    X(CPIOParser) \
+    X(CramFSParser) \
+    X(CRCParser) \
+    X(CryptoParser) \
+    X(DMGParser) \
+    X(DTBParser) \
+    X(ELFParser) \
+    X(FATParser) \
+    X(GIFParser) \
+    X(GzipParser) \
+    X(JPGParser) \
+    X(LinuxKernelParser) \
+    X(LZMAParser) \
+    X(MBRParser) \
+    X(PDFParser) \
+    X(PEParser) \
+    X(PNGParser) \
+    X(RARParser) \
+    X(RomfsParser) \
+    X(SevenZipParser) \
+    X(SquashFSParser) \
+    X(SVGParser) \
+    X(TARParser) \
+    X(UImageParser) \
+    X(XZParser) \
+    X(ZIPParser)
@@ -11,8 +11,10 @@
 class CABParser : public BaseParser {
 public:
     std::string name() const override { return "CAB"; }
+    std::vector<uint8_t> anchorBytes() const override { return {'M'}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         // Signature "MSCF" (4D 53 43 46)
         if (offset + 4 > blob.size()) return false;
         return blob[offset] == 'M' &&
@@ -21,7 +23,7 @@ public:
                blob[offset+3] == 'F';
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "CAB";
@@ -73,16 +75,14 @@ public:
 
         r.length = std::min<size_t>(cbCabinet, available);
         r.isValid = sizeFits && filesOffPlausible && countsPlausible;
-        std::ostringstream info;
-        info << "Microsoft Cabinet archive, size=" << cbCabinet
-             << " bytes, folders=" << nFolders
-             << ", files=" << nFiles
-             << ", flags=" << describeFlags(flags)
-             << ", setID=" << setID
-             << ", index=" << iCabinet
-             << ", coffFiles=" << coffFiles;
-        r.info = info.str();
-        Logger::debug(r.info);
+        r.info.text("Microsoft Cabinet archive, size=").field("size", cbCabinet)
+              .text(" bytes, folders=").field("folders", nFolders)
+              .text(", files=").field("files", nFiles)
+              .text(", flags=").field("flags", describeFlags(flags))
+              .text(", setID=").field("set_id", setID)
+              .text(", index=").field("index", iCabinet)
+              .text(", coffFiles=").field("coff_files", coffFiles);
+        Logger::debug(r.info.str());
 
         return r;
     }
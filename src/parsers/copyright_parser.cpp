@@ -7,8 +7,10 @@
 class CopyrightParser : public BaseParser {
 public:
     std::string name() const override { return "COPYRIGHT"; }
+    std::vector<uint8_t> anchorBytes() const override { return {'c', 'C'}; }
+    bool needsStructuredData() const override { return true; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         const char* kw = "copyright";
         size_t kwLen = 9;
 
@@ -23,7 +25,7 @@ public:
         return true;
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "COPYRIGHT";
@@ -7,21 +7,24 @@
 
 class CPIOParser : public BaseParser {
 public:
-    bool match(const std::vector<std::uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<std::uint8_t>& blob, size_t offset) override;
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset) override;
     std::string name() const override { return "CPIO"; }
+    std::vector<uint8_t> anchorBytes() const override { return {'0'}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool needsStructuredData() const override { return true; }
 };
 
-static bool is_cpio_magic(const std::vector<uint8_t>& blob, size_t offset) {
+static bool is_cpio_magic(const ByteView& blob, size_t offset) {
     return offset + 6 <= blob.size() &&
            std::memcmp(&blob[offset], "070701", 6) == 0;
 }
 
-bool CPIOParser::match(const std::vector<std::uint8_t>& blob, size_t offset) {
+bool CPIOParser::match(const ByteView& blob, size_t offset) {
     return is_cpio_magic(blob, offset);
 }
 
-ScanResult CPIOParser::parse(const std::vector<std::uint8_t>& blob, size_t offset) {
+ScanResult CPIOParser::parse(const ByteView& blob, size_t offset) {
     ScanResult result;
     result.offset = offset;
     result.type = name();
@@ -2,9 +2,7 @@
 #include "parser_registration.hpp"
 #include <cstdint>
 #include <string>
-#include <sstream>
 #include <algorithm>
-#include <iomanip>
 #include "cramfs.hpp"
 #include "helpers.hpp"
 #include "logger.hpp"
@@ -13,15 +11,18 @@
 class CramFSParser : public BaseParser {
 public:
     std::string name() const override { return "CramFS"; }
+    std::vector<uint8_t> anchorBytes() const override { return {0x45, 0x28}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool blockAligned() const override { return true; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         if (offset + 8 > blob.size()) return false;
         uint32_t le = read_le32(blob, offset);
         uint32_t be = read_be32(blob, offset);
         return le == 0x28CD3D45u || be == 0x28CD3D45u || le == 0x453DCD28u || be == 0x453DCD28u;
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "CramFS";
@@ -31,7 +32,7 @@ public:
         if (offset + 0x40 > blob.size()) {
             r.info = "Truncated CramFS superblock";
             r.length = blob.size() - offset;
-            Logger::error(r.info);
+            Logger::error(r.info.str());
             return r;
         }
 
@@ -46,7 +47,7 @@ public:
         } else {
             r.info = "Invalid CramFS magic";
             r.length = blob.size() - offset;
-            Logger::error(r.info);
+            Logger::error(r.info.str());
             return r;
         }
 
@@ -73,7 +74,7 @@ public:
             r.info = "Truncated root inode";
             r.length = computedLen;
             r.isValid = false;
-            Logger::error(r.info);
+            Logger::error(r.info.str());
             return r;
         }
         CramfsInode root = parseInode(blob, rootInoOff, isLE);
@@ -131,25 +132,26 @@ public:
         }
 
         // Compose info
-        std::ostringstream info;
-        info << "Compressed ROM File System"
-             << ", endianness=" << (isLE ? "LE" : "BE")
-             << ", declared size=" << declaredSize
-             << ", flags=0x" << std::hex << flags << std::dec
-             << ", future=0x" << std::hex << future << std::dec;
-
-        if (!sig.empty()) info << ", signature=\"" << sig << "\"";
-        info << ", root: mode=0x" << std::hex << root.mode << std::dec
-             << ", uid=" << root.uid << ", gid=" << (int)root.gid
-             << ", namelen=" << (int)root.namelen << (rootName.empty() ? "" : (", name=\"" + rootName + "\""))
-             << ", offset=" << root.offset << ", size=" << root.size;
+        ResultInfo info;
+        info.text("Compressed ROM File System")
+            .text(", endianness=").field("endianness", isLE ? "LE" : "BE")
+            .text(", declared size=").field("declared_size", declaredSize)
+            .text(", flags=0x").field("flags", flags, InfoField::HEX)
+            .text(", future=0x").field("future", future, InfoField::HEX);
+
+        if (!sig.empty()) info.text(", signature=\"").field("signature", sig).text("\"");
+        info.text(", root: mode=0x").field("root_mode", root.mode, InfoField::HEX)
+            .text(", uid=").field("root_uid", root.uid).text(", gid=").field("root_gid", root.gid)
+            .text(", namelen=").field("root_namelen", root.namelen);
+        if (!rootName.empty()) info.text(", name=\"").field("root_name", rootName).text("\"");
+        info.text(", offset=").field("root_offset", root.offset).text(", size=").field("root_size", root.size);
 
         // Final validity
         bool valid = plausibleDecl && rootIsDir && rootNameOK && rootOffsetOK && rootSizeOK && (!root.namelen || rootInoOff + 12 + root.namelen <= offset + declaredSize);
         //if (rootIsDir && dirRegionOK) valid = valid && sampleOK;
 
-        r.info = info.str();
-        Logger::debug(r.info);
+        r.info = std::move(info);
+        Logger::debug(r.info.str());
         r.length = computedLen;
         r.isValid = valid;
         r.extractorType = "7Z";
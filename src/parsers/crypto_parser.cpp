@@ -0,0 +1,11 @@
+#include "parser_registration.hpp"
+#include "crypto_table_parser.hpp"
+
+// Hash and cipher constants (SHA-256, SHA-1, MD5, DES, Blowfish, ChaCha),
+// see crypto_constants.cpp
+class CryptoParser : public CryptoTableParser {
+public:
+    CryptoParser() : CryptoTableParser("CRYPTO") {}
+};
+
+REGISTER_PARSER(CryptoParser)
@@ -0,0 +1,81 @@
+#pragma once
+#include "base_parser.hpp"
+#include "crypto_constants.hpp"
+#include "signature_index.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Reports the CryptoConstant tables of one family. The constants are found
+// by the scanner's single signature pass, so probe() is one lookup and the
+// cost does not grow with the number of known tables.
+class CryptoTableParser : public BaseParser {
+public:
+    explicit CryptoTableParser(const std::string& family)
+        : familyName(family), family(cryptoSignatureFamily(family)) {}
+
+    std::string name() const override { return familyName; }
+
+    void prepare(const ByteView&, const SignatureIndex& index) override {
+        signatures = &index;
+    }
+
+    std::vector<std::uint8_t> anchorBytes() const override {
+        std::vector<std::uint8_t> first;
+        for (const auto& c : cryptoConstants())
+            if (c.family == familyName && !c.signature.empty())
+                first.push_back(c.signature[0]);
+        return first;
+    }
+
+    bool match(const ByteView& blob, size_t offset) override {
+        return lookup(blob, offset) != nullptr;
+    }
+
+    ScanResult parse(const ByteView& blob, size_t offset) override {
+        if (auto r = probe(blob, offset))
+            return *r;
+        ScanResult r;
+        r.offset = offset;
+        r.type = familyName;
+        r.length = 0;
+        r.info = "No " + familyName + " table recognized";
+        r.isValid = false;
+        return r;
+    }
+
+    // A miss skips ahead to the family's next signature hit
+    std::optional<ScanResult> probe(const ByteView& blob, size_t offset) override {
+        const CryptoConstant* c = lookup(blob, offset);
+        if (!c) {
+            if (!signatures || !signatures->covers(blob))
+                return std::nullopt;
+            ScanResult miss;
+            miss.offset = offset;
+            miss.type = familyName;
+            miss.length = 0;
+            miss.isValid = false;
+            miss.nextCandidate = signatures->next(offset + 1, family);
+            return miss;
+        }
+        ScanResult r;
+        r.offset = offset;
+        r.type = familyName;
+        r.length = std::min(c->tableBytes, blob.size() - offset);
+        r.info = c->info;
+        r.isValid = true;
+        return r;
+    }
+
+private:
+    const CryptoConstant* lookup(const ByteView& blob, size_t offset) const {
+        if (!signatures || !signatures->covers(blob))
+            return nullptr;
+        const SignatureHit* hit = signatures->at(offset, family);
+        return hit ? &cryptoConstants()[hit->id] : nullptr;
+    }
+
+    std::string familyName;
+    uint32_t family;
+    const SignatureIndex* signatures = nullptr;
+};
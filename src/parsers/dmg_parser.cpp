@@ -5,7 +5,6 @@
 #include <cstring>
 #include <string>
 #include <vector>
-#include <sstream>
 #include <algorithm>
 #include "helpers.hpp"
 #include "logger.hpp"
@@ -15,12 +14,14 @@
 class DMGParser : public BaseParser {
 public:
     std::string name() const override { return "DMG"; }
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override;
+    std::vector<uint8_t> anchorBytes() const override { return {'k'}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset) override;
 };
 
 // Match only the UDIF footer signature at the given offset
-bool DMGParser::match(const std::vector<uint8_t>& blob, size_t offset) {
+bool DMGParser::match(const ByteView& blob, size_t offset) {
     if (offset + 12 > blob.size())
         return false;
 
@@ -43,7 +44,7 @@ bool DMGParser::match(const std::vector<uint8_t>& blob, size_t offset) {
     return true;
 }
 
-ScanResult DMGParser::parse(const std::vector<uint8_t>& blob, size_t trailerOffset) {
+ScanResult DMGParser::parse(const ByteView& blob, size_t trailerOffset) {
     ScanResult result;
     result.type = "DMG";
     result.extractorType = "7Z";
@@ -156,21 +157,21 @@ ScanResult DMGParser::parse(const std::vector<uint8_t>& blob, size_t trailerOffs
     result.length  = (size_t)dmgSize;
     result.isValid = true;
 
-    std::ostringstream info;
-    info << "Apple UDIF disk image (DMG), version=" << version
-         << ", headerSize=" << headerSize
-         << ", flags=0x" << std::hex << flags << std::dec
-         << ", dataForkOffset=" << dataForkOffset
-         << ", dataForkLength=" << dataForkLength
-         << ", rsrcForkOffset=" << rsrcForkOffset
-         << ", rsrcForkLength=" << rsrcForkLength
-         << ", xmlOffset=" << xmlOffset
-         << ", xmlLength=" << xmlLength
-         << ", imageVariant=" << imageVariant
-         << ", sectorCount=" << sectorCount
-         << ", wholeFile=" << (wholeFile ? "true" : "false");
-
-    result.info = info.str();
+    ResultInfo info;
+    info.text("Apple UDIF disk image (DMG), version=").field("version", version)
+        .text(", headerSize=").field("header_size", headerSize)
+        .text(", flags=0x").field("flags", flags, InfoField::HEX)
+        .text(", dataForkOffset=").field("data_fork_offset", dataForkOffset)
+        .text(", dataForkLength=").field("data_fork_length", dataForkLength)
+        .text(", rsrcForkOffset=").field("rsrc_fork_offset", rsrcForkOffset)
+        .text(", rsrcForkLength=").field("rsrc_fork_length", rsrcForkLength)
+        .text(", xmlOffset=").field("xml_offset", xmlOffset)
+        .text(", xmlLength=").field("xml_length", xmlLength)
+        .text(", imageVariant=").field("image_variant", imageVariant)
+        .text(", sectorCount=").field("sector_count", sectorCount)
+        .text(", wholeFile=").field("whole_file", wholeFile ? "true" : "false");
+
+    result.info = std::move(info);
     return result;
 }
 
@@ -13,19 +13,45 @@
 class DTBParser : public BaseParser {
 public:
     std::string name() const override { return "DTB"; }
+    std::vector<uint8_t> anchorBytes() const override { return {0xD0}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool needsStructuredData() const override { return true; }
 
-    bool match(const std::vector<std::uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<std::uint8_t>& blob, size_t offset ) override;
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset ) override;
+    std::optional<ScanResult> probe(const ByteView& blob, size_t offset) override;
+
+private:
+    ScanResult parseTree(const ByteView& blob, size_t offset);
 };
 
 
-bool DTBParser::match(const std::vector<std::uint8_t>& blob, size_t offset) {
+bool DTBParser::match(const ByteView& blob, size_t offset) {
     if (offset + sizeof(FdtHeader) > blob.size()) return false;
     uint32_t magic = read_be32(blob,offset);
     return magic == FDT_MAGIC;
 }
 
-ScanResult DTBParser::parse(const std::vector<std::uint8_t>& blob, size_t offset) {
+ScanResult DTBParser::parse(const ByteView& blob, size_t offset) {
+    if (match(blob, offset))
+        return parseTree(blob, offset);
+    ScanResult root;
+    root.offset = offset;
+    root.type = "DTB";
+    root.length = 0;
+    root.isValid = false;
+    root.info = "Invalid DTB magic";
+    return root;
+}
+
+std::optional<ScanResult> DTBParser::probe(const ByteView& blob, size_t offset) {
+    if (!match(blob, offset))
+        return std::nullopt;
+    return parseTree(blob, offset);
+}
+
+// Header and structure block walk, the magic has already been checked
+ScanResult DTBParser::parseTree(const ByteView& blob, size_t offset) {
     ScanResult root;
     root.offset = offset;
     root.type = "DTB";
@@ -35,12 +61,6 @@ ScanResult DTBParser::parse(const std::vector<std::uint8_t>& blob, size_t offset
     root.source = "";
     root.isValid = true;
 
-    if (!match(blob, offset)) {
-        root.isValid = false;
-        root.info = "Invalid DTB magic";
-        return root;
-    }
-
     // Parse header
     FdtHeader h{};
     h.magic            = read_be32(blob,offset+0);
@@ -1,7 +1,6 @@
 #include "base_parser.hpp"
 #include "parser_registration.hpp"
 #include <string>
-#include <sstream>
 #include <algorithm>
 #include "elf.hpp"
 
@@ -12,8 +11,10 @@ static inline bool inRange(size_t base, size_t need, size_t size) {
 class ELFParser : public BaseParser {
 public:
     std::string name() const override { return "ELF"; }
+    std::vector<uint8_t> anchorBytes() const override { return {0x7F}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         return offset + 4 <= blob.size() &&
                blob[offset] == 0x7F &&
                blob[offset + 1] == 'E' &&
@@ -21,7 +22,7 @@ public:
                blob[offset + 3] == 'F';
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult root;
         root.offset = offset;
         root.type = "ELF";
@@ -184,9 +185,8 @@ public:
         root.isValid = (root.length >= sizeof(Elf32_Ehdr)); // heuristic: at least header present
 
         // Optional: include class in info
-        std::ostringstream oss;
-        oss << "ELF" << ((ei_class == ELFCLASS64) ? "64" : "32");
-        root.info = oss.str();
+        root.info = "ELF";
+        root.info.field("bits", (ei_class == ELFCLASS64) ? 64 : 32);
 
         return root;
     }
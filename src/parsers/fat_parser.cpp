@@ -1,7 +1,6 @@
 #include "base_parser.hpp"
 #include "parser_registration.hpp"
 #include <string>
-#include <sstream>
 #include <vector>
 #include <cstdint>
 #include <algorithm>
@@ -11,8 +10,10 @@
 class FATParser : public BaseParser {
 public:
     std::string name() const override { return "FAT"; }
+    std::vector<uint8_t> anchorBytes() const override { return {0xEB, 0xE9}; }
+    bool blockAligned() const override { return true; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         // Need at least one sector (boot sector is 512 bytes, sometimes more, but 512 is safe minimum)
         if (offset + 64 > blob.size()) return false;
 
@@ -47,7 +48,7 @@ public:
         return hasFatString;
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "FAT";
@@ -112,17 +113,15 @@ public:
         r.length = len;
         r.isValid = bpOk && spcOk && fatsOk && mediaOk && totalsOk;
 
-        std::ostringstream info;
-        info << "FAT filesystem (" << fatType << ")"
-             << ", bytes/sector=" << bytesPerSector
-             << ", sectors/cluster=" << (uint32_t)sectorsPerCluster
-             << ", reserved=" << reservedSectors
-             << ", FATs=" << (uint32_t)numFATs
-             << ", sectors/FAT=" << sectorsPerFAT
-             << ", totalSectors=" << totalSectors
-             << ", size=" << imageSize << " bytes"
-             << ", valid=" << r.isValid;
-        r.info = info.str();
+        r.info.text("FAT filesystem (").field("fat_type", fatType).text(")")
+              .text(", bytes/sector=").field("bytes_per_sector", bytesPerSector)
+              .text(", sectors/cluster=").field("sectors_per_cluster", sectorsPerCluster)
+              .text(", reserved=").field("reserved_sectors", reservedSectors)
+              .text(", FATs=").field("fat_count", numFATs)
+              .text(", sectors/FAT=").field("sectors_per_fat", sectorsPerFAT)
+              .text(", totalSectors=").field("total_sectors", totalSectors)
+              .text(", size=").field("size", imageSize).text(" bytes")
+              .text(", valid=").field("valid", r.isValid);
 
         return r;
     }
@@ -2,20 +2,21 @@
 #include "parser_registration.hpp"
 #include <tuple>
 #include <string>
-#include <sstream>
 #include "helpers.hpp"
 class GIFParser : public BaseParser {
 public:
     std::string name() const override { return "GIF"; }
+    std::vector<uint8_t> anchorBytes() const override { return {'G'}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         return offset + 6 <= blob.size() &&
                blob[offset] == 'G' && blob[offset+1] == 'I' && blob[offset+2] == 'F' &&
                blob[offset+3] == '8' && (blob[offset+4] == '7' || blob[offset+4] == '9') &&
                blob[offset+5] == 'a';
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "GIF";
@@ -68,10 +69,9 @@ public:
             if (marker == 0x3B) { // Trailer — only valid here
                 r.isValid = true;
                 r.length = cursor - offset;
-                std::ostringstream info;
-                info << "Version: GIF" << (is89a ? "89a" : "87a")
-                     << ", Resolution: " << width << "x" << height;
-                r.info = info.str();
+                r.info.text("Version: GIF").field("version", is89a ? "89a" : "87a")
+                      .text(", Resolution: ").field("width", width)
+                      .text("x").field("height", height);
                 return r;
             }
 
@@ -5,6 +5,8 @@
 #include <iomanip>
 #include <cstdint>
 #include <zlib.h>
+#include "checksum.hpp"
+#include "budget.hpp"
 
 constexpr uint8_t GZIP_ID1 = 0x1F;
 constexpr uint8_t GZIP_ID2 = 0x8B;
@@ -13,13 +15,15 @@ constexpr uint8_t GZIP_CM_DEFLATE = 0x08;
 class GzipParser : public BaseParser {
 public:
     std::string name() const override { return "GZIP"; }
+    std::vector<uint8_t> anchorBytes() const override { return {GZIP_ID1}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
 
-    bool match(const std::vector<std::uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         if (offset + 2 > blob.size()) return false;
         return blob[offset] == GZIP_ID1 && blob[offset + 1] == GZIP_ID2 && blob[offset + 2] ==GZIP_CM_DEFLATE;
     }
 
-    ScanResult parse(const std::vector<std::uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "GZIP";
@@ -41,12 +45,12 @@ public:
         uint8_t xfl  = blob[offset + 8];
         uint8_t os   = blob[offset + 9];
 
-        std::ostringstream info;
-        info << "GZIP stream, compression method=" << (int)cm
-             << ", flags=0x" << std::hex << (int)flg << std::dec
-             << ", mtime=" << mtime
-             << ", extra flags=" << (int)xfl
-             << ", OS=" << (int)os;
+        ResultInfo info;
+        info.text("GZIP stream, compression method=").field("compression_method", cm)
+            .text(", flags=0x").field("flags", flg, InfoField::HEX)
+            .text(", mtime=").field("mtime", mtime)
+            .text(", extra flags=").field("extra_flags", xfl)
+            .text(", OS=").field("os", os);
 
         size_t cursor = offset + 10;
 
@@ -55,7 +59,7 @@ public:
             if (cursor + 2 <= blob.size()) {
                 uint16_t xlen = blob[cursor] | (blob[cursor+1] << 8);
                 cursor += 2 + xlen;
-                info << ", extra field length=" << xlen;
+                info.text(", extra field length=").field("extra_length", xlen);
             }
         }
         if (flg & 0x08) { // FNAME
@@ -64,7 +68,7 @@ public:
                 fname.push_back((char)blob[cursor++]);
             }
             cursor++;
-            if (!fname.empty()) info << ", original filename=\"" << fname << "\"";
+            if (!fname.empty()) info.text(", original filename=\"").field("filename", fname).text("\"");
         }
         if (flg & 0x10) { // FCOMMENT
             std::string comment;
@@ -72,7 +76,7 @@ public:
                 comment.push_back((char)blob[cursor++]);
             }
             cursor++;
-            if (!comment.empty()) info << ", comment=\"" << comment << "\"";
+            if (!comment.empty()) info.text(", comment=\"").field("comment", comment).text("\"");
         }
         if (flg & 0x02) { // FHCRC
             cursor += 2; // skip header CRC16
@@ -95,8 +99,8 @@ public:
                                 (blob[trailerPos+6] << 16) |
                                 (blob[trailerPos+7] << 24);
 
-        info << ", trailer CRC32=0x" << std::hex << crc32Trailer
-             << ", ISIZE=" << std::dec << isizeTrailer;
+        info.text(", trailer CRC32=0x").field("trailer_crc32", crc32Trailer, InfoField::HEX)
+            .text(", ISIZE=").field("isize", isizeTrailer);
 
         // Recompute CRC32 and ISIZE by decompressing
         z_stream strm{};
@@ -109,10 +113,10 @@ public:
             return r;
         }
 
-        uint32_t crc32Calc = crc32(0L, Z_NULL, 0);
+        uint32_t crc32Calc = 0;
         uint32_t isizeCalc = 0;
 
-        const size_t CHUNK = 16384;
+        const size_t CHUNK = 256 * 1024;
         std::vector<uint8_t> buffer(CHUNK);
 
         int ret;
@@ -138,31 +142,42 @@ public:
 
             size_t have = buffer.size() - strm.avail_out;
             if (have > 0) {
-                crc32Calc = crc32(crc32Calc, buffer.data(), have);
+                crc32Calc = crc32_ieee(buffer.data(), have, crc32Calc);
                 isizeCalc += have;
             }
 
+            // Inflate bombs: give up once the parser budget is spent
+            if (!budgetCharge(have))
+                break;
+
         } while (ret != Z_STREAM_END);
 
         inflateEnd(&strm);
 
+        if (ret != Z_STREAM_END) {
+            info.text(", not fully inflated");
+            r.length = blob.size() - offset;
+            r.info = std::move(info);
+            return r;
+        }
+
 
         bool crcMatch = (crc32Calc == crc32Trailer);
         bool sizeMatch = (isizeCalc == isizeTrailer);
 
-        info << ", recomputed CRC32=0x" << std::hex << crc32Calc
-             << ", recomputed ISIZE=" << std::dec << isizeCalc;
+        info.text(", recomputed CRC32=0x").field("crc32", crc32Calc, InfoField::HEX)
+            .text(", recomputed ISIZE=").field("size", isizeCalc);
 
         if (crcMatch && sizeMatch) {
-            info << " (validated)";
+            info.text(" (validated)");
             r.isValid = true;
         } else {
-            info << " (validation failed)";
+            info.text(" (validation failed)");
             r.isValid = false;
         }
 
         r.length = blob.size() - offset;
-        r.info = info.str();
+        r.info = std::move(info);
         return r;
     }
 };
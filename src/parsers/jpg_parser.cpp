@@ -1,21 +1,21 @@
 #include "parser_registration.hpp"
 #include <tuple>
 #include <string>
-#include <sstream>
-#include <iomanip>
 
 class JPGParser : public BaseParser {
 public:
     std::string name() const override { return "JPG"; }
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override;
+    std::vector<uint8_t> anchorBytes() const override { return {0xFF}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset) override;
 
 private:
-    bool findSOF(const std::vector<uint8_t>& blob, size_t start, size_t& width, size_t& height);
+    bool findSOF(const ByteView& blob, size_t start, size_t& width, size_t& height);
 };
 
 
-bool JPGParser::match(const std::vector<uint8_t>& blob, size_t offset) {
+bool JPGParser::match(const ByteView& blob, size_t offset) {
     // JPEG magic: FF D8
     return offset + 1 < blob.size() &&
            blob[offset] == 0xFF &&
@@ -24,7 +24,7 @@ bool JPGParser::match(const std::vector<uint8_t>& blob, size_t offset) {
            (blob[offset + 3] == 0xE0 || blob[offset + 3] == 0xE1 ||blob[offset + 3] == 0xDB);
 }
 
-ScanResult JPGParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
+ScanResult JPGParser::parse(const ByteView& blob, size_t offset) {
     size_t length = 0;
     size_t width = 0, height = 0;
     size_t i = offset + 2;
@@ -77,13 +77,12 @@ ScanResult JPGParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
 
     if (!foundEnd) length = blob.size() - offset;
 
-    std::ostringstream info;
-    info << "Resolution: " << width << "x" << height;
     ScanResult result;
     result.offset = offset;
     result.type = "JPG";
     result.extractorType = "RAW";
-    result.info = info.str();
+    result.info.text("Resolution: ").field("width", width)
+               .text("x").field("height", height);
     result.length = length;
     result.isValid = true;
     return result;
@@ -1,89 +1,125 @@
 #include "parser_registration.hpp"
+#include "signature_index.hpp"
+#include "helpers.hpp"
 #include <string>
 #include <vector>
-#include <sstream>
 #include <algorithm>
 #include <cstdint>
-#include "logger.hpp"
-
-static bool matchLinuxBootImageMagic(const std::vector<uint8_t>& b, size_t off) {
-    // b"\xb8\xc0\x07\x8e\xd8\xb8\x00\x90\x8e\xc0\xb9\x00\x01\x29\xf6\x29"
-    static const uint8_t sig[] = {
-        0xB8,0xC0,0x07,0x8E,0xD8,0xB8,0x00,0x90,0x8E,0xC0,0xB9,0x00,0x01,0x29,0xF6,0x29
-    };
-    return off + sizeof(sig) <= b.size() &&
-           std::equal(sig, sig + sizeof(sig), &b[off]);
+#include <cstring>
+
+// Ids of the LinuxKernel signature family
+enum LinuxSignature : uint32_t {
+    BOOT_IMAGE,    // x86 boot sector code, "!HdrS" 514 bytes later
+    ARM64_MAGIC,   // "ARMd" at 0x38 of an arm64 Image
+    ZIMAGE_LE,     // ARM zImage magic at 0x24
+    ZIMAGE_BE,
+    BANNER,        // "Linux version "
+    SYMBOL_TABLE,  // "\0" "0" "\0" "1" ... "9" "\0" of kallsyms
+};
+
+static const uint8_t BOOT_IMAGE_MAGIC[] = {
+    0xB8,0xC0,0x07,0x8E,0xD8,0xB8,0x00,0x90,0x8E,0xC0,0xB9,0x00,0x01,0x29,0xF6,0x29
+};
+static const uint8_t ARM64_IMAGE_MAGIC[] = {'A', 'R', 'M', 'd'};
+static const uint8_t ZIMAGE_MAGIC_LE[] = {0x18, 0x28, 0x6F, 0x01};
+static const uint8_t ZIMAGE_MAGIC_BE[] = {0x01, 0x6F, 0x28, 0x18};
+static const char BANNER_PREFIX[] = "Linux version ";
+
+// Offsets of the magics from the start of the image
+static const size_t ARM64_MAGIC_OFFSET = 0x38;
+static const size_t ZIMAGE_MAGIC_OFFSET = 0x24;
+
+// A banner is one line of a few hundred bytes at most
+static const size_t MAX_BANNER_LENGTH = 1024;
+
+static uint32_t linuxSignatureFamily() {
+    static const uint32_t family = [] {
+        SignatureSet& set = SignatureSet::instance();
+        uint32_t f = set.family("LinuxKernel");
+        set.add(f, BOOT_IMAGE_MAGIC, sizeof(BOOT_IMAGE_MAGIC), BOOT_IMAGE);
+        set.add(f, ARM64_IMAGE_MAGIC, sizeof(ARM64_IMAGE_MAGIC), ARM64_MAGIC);
+        set.add(f, ZIMAGE_MAGIC_LE, sizeof(ZIMAGE_MAGIC_LE), ZIMAGE_LE);
+        set.add(f, ZIMAGE_MAGIC_BE, sizeof(ZIMAGE_MAGIC_BE), ZIMAGE_BE);
+        set.add(f, reinterpret_cast<const uint8_t*>(BANNER_PREFIX), sizeof(BANNER_PREFIX) - 1, BANNER);
+        std::vector<uint8_t> symbols;
+        for (char c = '0'; c <= '9'; ++c) {
+            symbols.push_back(0x00);
+            symbols.push_back(static_cast<uint8_t>(c));
+        }
+        symbols.push_back(0x00);
+        set.add(f, symbols.data(), symbols.size(), SYMBOL_TABLE);
+        return f;
+    }();
+    return family;
 }
 
-static bool hasHdrSAt(const std::vector<uint8_t>& b, size_t off) {
-    // Expect "!HdrS" 514 bytes after magic
-    const size_t hdrsOff = off + 514;
-    if (hdrsOff + 5 > b.size()) return false;
-    return b[hdrsOff] == '!' && b[hdrsOff+1] == 'H' && b[hdrsOff+2] == 'd' &&
-           b[hdrsOff+3] == 'r' && b[hdrsOff+4] == 'S';
+static bool bytesAt(const ByteView& b, size_t off, const uint8_t* bytes, size_t len) {
+    return off + len <= b.size() && std::memcmp(&b[off], bytes, len) == 0;
 }
 
-static bool matchArm64BootMagic(const std::vector<uint8_t>& b, size_t off) {
-    // 56 bytes into the image: 8 zero bytes, then "ARMd"
-    const size_t magicOffset = 0x30;
-    if (off + magicOffset + 12 > b.size()) return false;
-    for (int i = 0; i < 8; ++i) {
-        if (b[off + magicOffset + i] != 0x00) return false;
-    }
-    return b[off + magicOffset + 8] == 'A' &&
-           b[off + magicOffset + 9] == 'R' &&
-           b[off + magicOffset + 10] == 'M' &&
-           b[off + magicOffset + 11] == 'd';
+static bool matchLinuxBootImageMagic(const ByteView& b, size_t off) {
+    return bytesAt(b, off, BOOT_IMAGE_MAGIC, sizeof(BOOT_IMAGE_MAGIC));
 }
 
-static bool matchArmZImageMagic(const std::vector<uint8_t>& b, size_t off) {
-    // Magic bytes: 0x18 0x28 0x6F 0x01 or 0x01 0x6F 0x28 0x18 (endianness variants)
-    if (off + 4 > b.size()) return false;
-    const uint8_t* p = &b[off];
-    bool le = p[0] == 0x18 && p[1] == 0x28 && p[2] == 0x6F && p[3] == 0x01;
-    bool be = p[0] == 0x01 && p[1] == 0x6F && p[2] == 0x28 && p[3] == 0x18;
-    return le || be;
+static bool hasHdrSAt(const ByteView& b, size_t off) {
+    // Expect "!HdrS" 514 bytes after magic
+    static const uint8_t hdrs[] = {'!', 'H', 'd', 'r', 'S'};
+    return bytesAt(b, off + 514, hdrs, sizeof(hdrs));
 }
 
-static std::string getCString(const uint8_t* data, size_t maxLen) {
-    size_t len = 0;
-    while (len < maxLen && data[len] != '\0') ++len;
-    return std::string(reinterpret_cast<const char*>(data), len);
+static bool matchArm64BootMagic(const ByteView& b, size_t off) {
+    // "ARMd" at 0x38 of the image, after 8 zero bytes (res4)
+    if (off < ARM64_MAGIC_OFFSET || !bytesAt(b, off, ARM64_IMAGE_MAGIC, sizeof(ARM64_IMAGE_MAGIC)))
+        return false;
+    for (size_t i = off - 8; i < off; ++i) {
+        if (b[i] != 0x00) return false;
+    }
+    return true;
 }
 
-static std::string findKernelBanner(const std::vector<uint8_t>& b, size_t off = 0) {
-    static const char needle[] = "Linux version ";
-    auto it = std::search(b.begin() + off, b.end(), needle, needle + sizeof(needle) - 1);
-    if (it == b.end()) return "";
-    // read up to newline
-    auto end = std::find(it, b.end(), '\n');
-    return std::string(it, end+1);
+// Size of an x86 bzImage from its setup header: the real-mode setup
+// sectors plus the boot sector, then the protected-mode part in 16-byte
+// paragraphs. 0 if the header does not give it.
+static size_t bzImageSize(const ByteView& b, size_t off) {
+    size_t setupSects = b[off + 0x1F1];
+    uint32_t sysSize = read_le32(b, off + 0x1F4);
+    if (setupSects == 0)
+        setupSects = 4;  // boot protocols before 2.00
+    return sysSize ? (setupSects + 1) * 512 + static_cast<size_t>(sysSize) * 16 : 0;
 }
 
-static bool hasLinuxSymbolTable(const std::vector<uint8_t>& b) {
-    // Same magic: "\x00""0""\x00""1""\x00""2"... up to "9"
-    // Build the pattern once
-    static std::vector<uint8_t> pat;
-    if (pat.empty()) {
-        for (char c = '0'; c <= '9'; ++c) {
-            pat.push_back(0x00);
-            pat.push_back(static_cast<uint8_t>(c));
-        }
-        pat.push_back(0x00);
-    }
-    size_t matches = 0;
-    // Overlapping search
-    for (size_t i = 0; i + pat.size() <= b.size(); ++i) {
-        if (std::equal(pat.begin(), pat.end(), b.begin() + i)) {
-            matches++;
-        }
+// Image size of an ARM zImage whose magic is at `off`, 0 if there is none.
+// The magic is followed by the start and end address of the image.
+static size_t matchArmZImageMagic(const ByteView& b, size_t off) {
+    // Magic bytes: 0x18 0x28 0x6F 0x01 or 0x01 0x6F 0x28 0x18 (endianness variants)
+    if (off + 12 > b.size())
+        return 0;
+    uint32_t start, end;
+    if (bytesAt(b, off, ZIMAGE_MAGIC_LE, sizeof(ZIMAGE_MAGIC_LE))) {
+        start = read_le32(b, off + 4);
+        end = read_le32(b, off + 8);
+    } else if (bytesAt(b, off, ZIMAGE_MAGIC_BE, sizeof(ZIMAGE_MAGIC_BE))) {
+        start = read_be32(b, off + 4);
+        end = read_be32(b, off + 8);
+    } else {
+        return 0;
     }
-    return matches == 1;
+    return end > start ? end - start : 0;
+}
+
+// The banner line at `off` with its newline, if there is one within
+// MAX_BANNER_LENGTH bytes
+static std::string findKernelBanner(const ByteView& b, size_t off) {
+    size_t len = std::min(b.size() - off, MAX_BANNER_LENGTH);
+    const uint8_t* start = &b[off];
+    const void* nl = std::memchr(start, '\n', len);
+    if (nl)
+        len = static_cast<const uint8_t*>(nl) - start + 1;
+    return std::string(reinterpret_cast<const char*>(start), len);
 }
 
 static bool bannerLooksValid(const std::string& s) {
     // Binwalk heuristics
-    const size_t MIN_FILE_SIZE = 100 * 1024; // applied externally
     const size_t MIN_VERSION_STRING_LENGTH = 75;
     if (s.size() <= MIN_VERSION_STRING_LENGTH) return false;
     if (s.find("gcc ") == std::string::npos) return false;
@@ -99,89 +135,151 @@ static bool bannerLooksValid(const std::string& s) {
     return ok;
 }
 
+// Linux kernel images: x86 bzImage, arm64 Image, ARM zImage and raw
+// vmlinux by its banner. All signatures, including the kallsyms marker that
+// tells a full vmlinux, come from the scanner's single signature pass, so a
+// probe is a few compares and a miss skips to the next hit of the family.
 class LinuxKernelParser : public BaseParser {
 public:
+    LinuxKernelParser() : family(linuxSignatureFamily()) {}
+
     std::string name() const override { return "LinuxKernel"; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
-        // Try boot image magic and validation
-        if (matchLinuxBootImageMagic(blob, offset) && hasHdrSAt(blob, offset)) return true;
-        if (matchArm64BootMagic(blob, offset)) return true;
+    void prepare(const ByteView&, const SignatureIndex& index) override {
+        signatures = &index;
+        symbolTables = -1;
+    }
 
-        // ARM zImage: magic appears 36 bytes after real start, so allow backward correction
-        const size_t MAGIC_OFFSET = 36;
-        if (offset >= MAGIC_OFFSET && matchArmZImageMagic(blob, offset)) return true;
+    std::vector<std::uint8_t> anchorBytes() const override {
+        return {BOOT_IMAGE_MAGIC[0], ARM64_IMAGE_MAGIC[0], ZIMAGE_MAGIC_LE[0], ZIMAGE_MAGIC_BE[0],
+                static_cast<uint8_t>(BANNER_PREFIX[0])};
+    }
 
-        // Kernel version banner anywhere (cheap pre-check at current offset)
-        if (offset + 15 < blob.size()) {
-            // exact match for the prefix bytes at current offset
-            static const char prefix[] = "Linux version ";
-            if (std::equal(prefix, prefix + sizeof(prefix) - 1, &blob[offset])) return true;
-        }
-        return false;
+    bool match(const ByteView& blob, size_t offset) override {
+        return probeAt(blob, offset).has_value();
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
+        if (auto r = probeAt(blob, offset))
+            return *r;
+
+        // Fallback
         ScanResult r;
         r.offset = offset;
         r.type = name();
         r.isValid = true;
+        r.info = "No magic at start; consider scanning for ELF header or decompressing payload";
+        r.length = blob.size() - offset;
+        return r;
+    }
+
+    // A miss skips ahead to the family's next signature hit
+    std::optional<ScanResult> probe(const ByteView& blob, size_t offset) override {
+        if (auto r = probeAt(blob, offset))
+            return r;
+        if (!signatures || !signatures->covers(blob))
+            return std::nullopt;
+        ScanResult miss;
+        miss.offset = offset;
+        miss.type = name();
+        miss.length = 0;
+        miss.isValid = false;
+        miss.nextCandidate = signatures->next(offset + 1, family);
+        return miss;
+    }
+
+private:
+    // Each magic is checked once and the result is built from the first hit
+    std::optional<ScanResult> probeAt(const ByteView& blob, size_t offset) {
+        ScanResult r;
+        r.offset = offset;
+        r.type = name();
+        r.isValid = true;
+
+        // An image whose size is not known is reported up to the end of
+        // the blob but not skipped, so what follows it is still scanned
 
         // Linux boot image with !HdrS
         if (matchLinuxBootImageMagic(blob, offset) && hasHdrSAt(blob, offset)) {
+            size_t imageSize = bzImageSize(blob, offset);
             r.info = "Linux kernel boot image";
             r.length = blob.size() - offset;
+            if (imageSize)
+                r.length = std::min(imageSize, r.length);
+            else
+                r.confident = false;
             return r;
         }
 
-        // ARM64 boot image
+        // ARM64 boot image, the magic is 0x38 bytes into the header
         if (matchArm64BootMagic(blob, offset)) {
-            // True start is 0x30 bytes before this signature
-            r.offset = offset - 0x30;
-            // If you implement header parsing, set size/endian here
+            r.offset = offset - ARM64_MAGIC_OFFSET;
+            uint64_t imageSize = read_le64(blob, r.offset + 0x10);  // 0 before Linux 3.17
             r.info = "ARM64 boot image header detected";
             r.length = blob.size() - r.offset;
+            if (imageSize)
+                r.length = static_cast<size_t>(std::min<uint64_t>(imageSize, r.length));
+            else
+                r.confident = false;
             return r;
         }
 
-        // ARM zImage (adjust offset back by 36 bytes)
-        const size_t MAGIC_OFFSET = 36;
-        if (offset >= MAGIC_OFFSET && matchArmZImageMagic(blob, offset)) {
-            r.extractorType = "XZ";
-            r.offset = offset - MAGIC_OFFSET;
-            r.info = "ARM zImage header detected";
-            r.length = blob.size() - r.offset;
-            return r;
+        // ARM zImage: magic appears 36 bytes after real start, so adjust the offset back
+        if (offset >= ZIMAGE_MAGIC_OFFSET) {
+            size_t imageSize = matchArmZImageMagic(blob, offset);
+            if (imageSize > ZIMAGE_MAGIC_OFFSET) {
+                r.extractorType = "XZ";
+                r.offset = offset - ZIMAGE_MAGIC_OFFSET;
+                r.info = "ARM zImage header detected";
+                r.length = std::min(imageSize, blob.size() - r.offset);
+                return r;
+            }
         }
 
         // Kernel banner detection (vmlinux or decompressed kernel)
+        if (offset + 15 >= blob.size() ||
+            !bytesAt(blob, offset, reinterpret_cast<const uint8_t*>(BANNER_PREFIX), sizeof(BANNER_PREFIX) - 1))
+            return std::nullopt;
+
         std::string banner = findKernelBanner(blob, offset);
-        if (!banner.empty()) {
-            // Heuristics for confidence and symbol table
-            bool valid = bannerLooksValid(banner);
-            bool symtab = hasLinuxSymbolTable(blob);
-
-            // If symbol table is present, assume raw vmlinux (full file)
-            if (symtab) {
-                r.offset = 0;
-                r.length = blob.size();
-                r.info = banner.substr(0, banner.size() - (banner.back() == '\n' ? 1 : 0)) +
-                         ", has symbol table: true";
-            } else {
-                r.length = banner.size();
-                r.info = banner.substr(0, banner.size() - (banner.back() == '\n' ? 1 : 0)) +
-                         ", has symbol table: false";
-            }
-            r.confident = false;
-            r.isValid = valid;
-            return r;
-        }
+        // Heuristics for confidence and symbol table
+        bool valid = bannerLooksValid(banner);
+        bool symtab = hasLinuxSymbolTable(blob);
+        size_t lineLength = banner.size();
+        if (banner.back() == '\n')
+            banner.pop_back();
 
-        // Fallback
-        r.info = "No magic at start; consider scanning for ELF header or decompressing payload";
-        r.length = blob.size() - offset;
+        // If symbol table is present, assume raw vmlinux (full file)
+        if (symtab) {
+            r.offset = 0;
+            r.length = blob.size();
+        } else {
+            r.length = lineLength;
+        }
+        r.info.field("banner", banner)
+              .text(", has symbol table: ").field("symbol_table", symtab ? "true" : "false");
+        r.confident = false;
+        r.isValid = valid;
         return r;
     }
+
+    // Exactly one kallsyms marker in the blob, counted once per blob from
+    // the signature hits
+    bool hasLinuxSymbolTable(const ByteView& blob) {
+        if (!signatures || !signatures->covers(blob))
+            return false;
+        if (symbolTables < 0) {
+            symbolTables = 0;
+            for (const SignatureHit& hit : signatures->all())
+                if (hit.family == family && hit.id == SYMBOL_TABLE)
+                    ++symbolTables;
+        }
+        return symbolTables == 1;
+    }
+
+    uint32_t family;
+    const SignatureIndex* signatures = nullptr;
+    long symbolTables = -1;  // -1: not counted for this blob yet
 };
 
-//REGISTER_PARSER(LinuxKernelParser)
\ No newline at end of file
+REGISTER_PARSER(LinuxKernelParser)
@@ -1,8 +1,6 @@
 #include "parser_registration.hpp"
 #include <string>
 #include <vector>
-#include <sstream>
-#include <iomanip>
 #include <cstring>
 #include "helpers.hpp"
 #include "logger.hpp"
@@ -21,7 +19,7 @@ struct LZMAHeader {
     uint64_t uncompressedSize;
 };
 
-static LZMAHeader parseHeader(const std::vector<uint8_t>& blob, size_t offset) {
+static LZMAHeader parseHeader(const ByteView& blob, size_t offset) {
     LZMAHeader h{};
     h.props = blob[offset];
     h.dictSize = blob[offset+1] |
@@ -37,8 +35,9 @@ static LZMAHeader parseHeader(const std::vector<uint8_t>& blob, size_t offset) {
 class LZMAParser : public BaseParser {
 public:
     std::string name() const override { return "LZMA"; }
+    std::vector<uint8_t> anchorBytes() const override { return {std::begin(supported_props), std::end(supported_props)}; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         if (offset + 13 > blob.size()) return false;
         uint8_t props = blob[offset];
         uint32_t dict = blob[offset+1] |
@@ -52,7 +51,7 @@ public:
         return propOK && dictOK;
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult res;
         res.offset = offset;
         res.type = "LZMA";
@@ -66,16 +65,13 @@ public:
 
         LZMAHeader h = parseHeader(blob, offset);
 
-        std::ostringstream info;
-        info << "LZMA compressed data, props=0x"
-             << std::hex << std::setw(2) << std::setfill('0') << (int)h.props
-             << std::dec << ", dict=" << h.dictSize;
+        // props is one of supported_props, always two hex digits
+        res.info.text("LZMA compressed data, props=0x").field("props", h.props, InfoField::HEX)
+                .text(", dict=").field("dict_size", h.dictSize);
         if (h.uncompressedSize != 0xFFFF'FFFF'FFFF'FFFFull)
-            info << ", uncompressed=" << h.uncompressedSize;
+            res.info.text(", uncompressed=").field("uncompressed_size", h.uncompressedSize);
         else
-            info << ", uncompressed=unknown";
-
-        res.info = info.str();
+            res.info.text(", uncompressed=unknown");
         res.length = blob.size() - offset; // compressed length (best guess)
         res.isValid = true;
         if(h.uncompressedSize > MAX_ANALYZED_FILE_SIZE)
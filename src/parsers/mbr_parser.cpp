@@ -1,15 +1,12 @@
 #include "base_parser.hpp"
 #include "parser_registration.hpp"
 #include <string>
-#include <sstream>
 #include <vector>
 #include <cstdint>
-#include <iomanip>
 
 #include "base_parser.hpp"
 #include "parser_registration.hpp"
 #include <string>
-#include <sstream>
 #include <vector>
 #include <cstdint>
 #include <unordered_map>
@@ -26,14 +23,28 @@ static const std::unordered_map<uint8_t,std::string> typeNames = {
 class MBRParser : public BaseParser {
 public:
     std::string name() const override { return "MBR"; }
+    bool blockAligned() const override { return true; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         if(offset != 0)return false;
         if (offset + 512 > blob.size()) return false;
         return blob[offset + 510] == 0x55 && blob[offset + 511] == 0xAA;
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    // Only offset 0 is checked, there is no point in probing the others
+    std::optional<ScanResult> probe(const ByteView& blob, size_t offset) override {
+        if (match(blob, offset))
+            return parse(blob, offset);
+        ScanResult r;
+        r.offset = offset;
+        r.type = "MBR";
+        r.length = 0;
+        r.isValid = false;
+        r.nextCandidate = blob.size();
+        return r;
+    }
+
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "MBR";
@@ -49,8 +60,8 @@ public:
 
         // Parse partition entries
         size_t partBase = offset + 446;
-        std::ostringstream info;
-        info << "DOS Master Boot Record";
+        ResultInfo info;
+        info.text("DOS Master Boot Record");
 
         bool foundPartition = false;
         for (int i = 0; i < 4; i++) {
@@ -65,14 +76,14 @@ public:
                 std::string typeName = (it != typeNames.end()) ? it->second : "Unknown";
                 uint64_t imageSize = (uint64_t)sectors * 512ULL;
 
-                info << ", partition: " << typeName
-                     << ", image size: " << imageSize << " bytes";
+                info.text(", partition: ").field("partition_type", typeName)
+                    .text(", image size: ").field("image_size", imageSize).text(" bytes");
                 break; // report first valid partition only
             }
         }
 
         r.isValid = foundPartition;
-        r.info = info.str();
+        r.info = std::move(info);
         return r;
     }
 };
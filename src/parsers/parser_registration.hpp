@@ -2,14 +2,13 @@
 #pragma once
 #include "parser_registry.hpp"
 
+// Defines the registration function of a built-in parser, called from the
+// list in builtin_parsers.hpp. Registration is explicit rather than done by
+// static initialisers, so linking the static library cannot drop parsers
+// and their order does not depend on the link order.
 #define REGISTER_PARSER(CLASSNAME) \
-    namespace { \
-        struct CLASSNAME##_AutoRegister { \
-            CLASSNAME##_AutoRegister() { \
-                ParserRegistry::instance().registerParser([]() { \
-                    return std::make_unique<CLASSNAME>(); \
-                }); \
-            } \
-        }; \
-        static CLASSNAME##_AutoRegister global_##CLASSNAME##_AutoRegister; \
+    void registerParser_##CLASSNAME(ParserRegistry& registry) { \
+        registry.registerParser([]() { \
+            return std::make_unique<CLASSNAME>(); \
+        }); \
     }
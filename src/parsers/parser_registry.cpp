@@ -0,0 +1,12 @@
+#include "parser_registry.hpp"
+#include "builtin_parsers.hpp"
+
+#define DECLARE_PARSER_REGISTRATION(CLASSNAME) void registerParser_##CLASSNAME(ParserRegistry& registry);
+HEXDIG_BUILTIN_PARSERS(DECLARE_PARSER_REGISTRATION)
+
+ParserRegistry ParserRegistry::builtins() {
+    ParserRegistry registry;
+#define CALL_PARSER_REGISTRATION(CLASSNAME) registerParser_##CLASSNAME(registry);
+    HEXDIG_BUILTIN_PARSERS(CALL_PARSER_REGISTRATION)
+    return registry;
+}
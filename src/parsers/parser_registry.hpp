@@ -9,11 +9,16 @@ class ParserRegistry {
 public:
     using Creator = std::function<std::unique_ptr<BaseParser>()>;
 
+    // Process-wide registry, filled with the built-in parsers on first use.
+    // Hosts add their own parsers before the first scan.
     static ParserRegistry& instance() {
-        static ParserRegistry registry;
+        static ParserRegistry registry = builtins();
         return registry;
     }
 
+    // A registry holding the built-in parsers
+    static ParserRegistry builtins();
+
     void registerParser(Creator creator) {
         creators.push_back(std::move(creator));
     }
@@ -1,6 +1,4 @@
 #include "parser_registration.hpp"
-#include <sstream>
-#include <iomanip>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -9,39 +7,39 @@
 class PDFParser : public BaseParser {
 public:
     std::string name() const override { return "PDF"; }
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override;
+    std::vector<uint8_t> anchorBytes() const override { return {'%'}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset) override;
 
 private:
-    std::string extractVersion(const std::vector<uint8_t>& blob, size_t offset);
-    size_t findLastEOF(const std::vector<uint8_t>& blob, size_t offset);
+    std::string extractVersion(const ByteView& blob, size_t offset);
+    size_t findLastEOF(const ByteView& blob, size_t offset);
 };
 
 
-bool PDFParser::match(const std::vector<uint8_t>& blob, size_t offset) {
+bool PDFParser::match(const ByteView& blob, size_t offset) {
     const char* magic = "%PDF-";
     return offset + 5 < blob.size() &&
            std::memcmp(&blob[offset], magic, 5) == 0;
 }
 
-ScanResult PDFParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
+ScanResult PDFParser::parse(const ByteView& blob, size_t offset) {
     std::string version = extractVersion(blob, offset);
     size_t end = findLastEOF(blob, offset);
     size_t length = end > offset ? end - offset : blob.size() - offset;
 
-    std::ostringstream info;
-    info << "Version: " << version;
     ScanResult result;
     result.offset = offset;
     result.type = "PDF";
     result.extractorType = "RAW";
     result.length = length;
     result.isValid = true;
-    result.info = info.str();
+    result.info.text("Version: ").field("version", version);
     return result;
 }
 
-std::string PDFParser::extractVersion(const std::vector<uint8_t>& blob, size_t offset) {
+std::string PDFParser::extractVersion(const ByteView& blob, size_t offset) {
     std::string version = "unknown";
     if (offset + 8 < blob.size()) {
         version = std::string(blob.begin() + offset + 5, blob.begin() + offset + 8);
@@ -49,7 +47,7 @@ std::string PDFParser::extractVersion(const std::vector<uint8_t>& blob, size_t o
     return version;
 }
 
-size_t PDFParser::findLastEOF(const std::vector<uint8_t>& blob, size_t offset) {
+size_t PDFParser::findLastEOF(const ByteView& blob, size_t offset) {
     const char* eof_marker = "%%EOF";
     const char* pdf_marker = "%PDF-";
 
@@ -8,22 +8,24 @@
 class PEParser : public BaseParser {
 public:
     std::string name() const override { return "EXE"; }
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override;
+    std::vector<uint8_t> anchorBytes() const override { return {'M'}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset) override;
 
 private:
-    bool isValidPE(const std::vector<uint8_t>& blob, size_t offset, size_t& peOffset, std::string& arch);
-    size_t estimateLength(const std::vector<uint8_t>& blob, size_t peOffset);
+    bool isValidPE(const ByteView& blob, size_t offset, size_t& peOffset, std::string& arch);
+    size_t estimateLength(const ByteView& blob, size_t peOffset);
 };
 
 
-bool PEParser::match(const std::vector<uint8_t>& blob, size_t offset) {
+bool PEParser::match(const ByteView& blob, size_t offset) {
     return offset + 2 < blob.size() &&
            blob[offset] == 'M' &&
            blob[offset + 1] == 'Z';
 }
 
-ScanResult PEParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
+ScanResult PEParser::parse(const ByteView& blob, size_t offset) {
     size_t peOffset = 0;
     std::string arch = "unknown";
     ScanResult result;
@@ -43,7 +45,7 @@ ScanResult PEParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
     return result;
 }
 
-bool PEParser::isValidPE(const std::vector<uint8_t>& blob, size_t offset, size_t& peOffset, std::string& arch) {
+bool PEParser::isValidPE(const ByteView& blob, size_t offset, size_t& peOffset, std::string& arch) {
     if (offset + 0x3C + 4 > blob.size()) return false;
 
     peOffset = static_cast<size_t>(
@@ -67,7 +69,7 @@ bool PEParser::isValidPE(const std::vector<uint8_t>& blob, size_t offset, size_t
     return true;
 }
 
-size_t PEParser::estimateLength(const std::vector<uint8_t>& blob, size_t peOffset) {
+size_t PEParser::estimateLength(const ByteView& blob, size_t peOffset) {
     // Heuristic: scan for next MZ or end of blob
     for (size_t i = peOffset + 4; i + 1 < blob.size(); ++i) {
         if (blob[i] == 'M' && blob[i + 1] == 'Z') {
@@ -1,19 +1,19 @@
 #include "parser_registration.hpp"
-#include <sstream>
-#include <iomanip>
 #include <cstring>
 #include <string>
 #include <vector>
-#include <zlib.h>
+#include "checksum.hpp"
 
 class PNGParser : public BaseParser {
 public:
     std::string name() const override { return "PNG"; }
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override;
+    std::vector<uint8_t> anchorBytes() const override { return {0x89}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset) override;
 };
 
-bool PNGParser::match(const std::vector<uint8_t>& blob, size_t offset) {
+bool PNGParser::match(const ByteView& blob, size_t offset) {
     // Binwalk-style signature:
     // PNG magic + IHDR length=13 + "IHDR"
     static const uint8_t sig[] = {
@@ -28,7 +28,7 @@ bool PNGParser::match(const std::vector<uint8_t>& blob, size_t offset) {
     return std::memcmp(&blob[offset], sig, sizeof(sig)) == 0;
 }
 
-ScanResult PNGParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
+ScanResult PNGParser::parse(const ByteView& blob, size_t offset) {
     ScanResult r;
     r.type = "PNG";
     r.offset = offset;
@@ -89,8 +89,7 @@ ScanResult PNGParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
         (blob[pos] << 24) | (blob[pos+1] << 16) |
         (blob[pos+2] << 8) | blob[pos+3];
 
-    uint32_t computed_crc = crc32(0L, Z_NULL, 0);
-    computed_crc = crc32(computed_crc, ihdr_type, 4 + ihdr_len);
+    uint32_t computed_crc = crc32_ieee(ihdr_type, 4 + ihdr_len);
 
     if (stored_crc != computed_crc) {
         r.info = "Invalid PNG: IHDR CRC mismatch";
@@ -122,8 +121,7 @@ ScanResult PNGParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
             (blob[pos + len + 2] << 8) |
             blob[pos + len + 3];
 
-        uint32_t crc = crc32(0L, Z_NULL, 0);
-        crc = crc32(crc, type, 4 + len);
+        uint32_t crc = crc32_ieee(type, 4 + len);
 
         if (crc != stored) {
             r.info = "Invalid PNG: chunk CRC mismatch";
@@ -135,9 +133,8 @@ ScanResult PNGParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
             r.isValid = true;
             r.length = pos - offset;
 
-            std::ostringstream info;
-            info << "Resolution: " << width << "x" << height;
-            r.info = info.str();
+            r.info.text("Resolution: ").field("width", width)
+                  .text("x").field("height", height);
             return r;
         }
 
@@ -1,7 +1,6 @@
 #include "base_parser.hpp"
 #include "parser_registration.hpp"
 #include <string>
-#include <sstream>
 #include <vector>
 #include <cstdint>
 #include <algorithm>
@@ -9,8 +8,10 @@
 class RARParser : public BaseParser {
 public:
     std::string name() const override { return "RAR"; }
+    std::vector<uint8_t> anchorBytes() const override { return {'R'}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         if (offset + 7 > blob.size()) return false;
         // RAR 4.x signature
         static const uint8_t sig4[7] = {0x52,0x61,0x72,0x21,0x1A,0x07,0x00};
@@ -27,7 +28,7 @@ public:
         return match4 || match5;
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "RAR";
@@ -73,10 +74,8 @@ public:
         r.length = std::min(cursor - offset, available);
         r.isValid = (blockCount > 0);
 
-        std::ostringstream info;
-        info << "RAR archive, format=" << (isRAR5 ? "RAR5" : "RAR4")
-             << ", blocks=" << blockCount;
-        r.info = info.str();
+        r.info.text("RAR archive, format=").field("format", isRAR5 ? "RAR5" : "RAR4")
+              .text(", blocks=").field("blocks", blockCount);
 
         return r;
     }
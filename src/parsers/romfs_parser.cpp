@@ -1,7 +1,6 @@
 #include "base_parser.hpp"
 #include "parser_registration.hpp"
 #include <string>
-#include <sstream>
 #include <vector>
 #include <cstdint>
 #include <algorithm>
@@ -9,8 +8,11 @@
 class RomfsParser : public BaseParser {
 public:
     std::string name() const override { return "ROMFS"; }
+    std::vector<uint8_t> anchorBytes() const override { return {'-'}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool blockAligned() const override { return true; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         if (offset + 8 > blob.size()) return false;
         std::string sig = "-rom1fs-";
         for (int i=0;i<8;i++) {
@@ -19,7 +21,7 @@ public:
         return true;
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "ROMFS";
@@ -42,10 +44,8 @@ public:
         r.length = computedLen;
         r.isValid = (fsSize > 0 && fsSize <= available);
 
-        std::ostringstream info;
-        info << "ROMFS filesystem, size=" << fsSize
-             << " bytes, checksum=0x" << std::hex << checksum << std::dec;
-        r.info = info.str();
+        r.info.text("ROMFS filesystem, size=").field("size", fsSize)
+              .text(" bytes, checksum=0x").field("checksum", checksum, InfoField::HEX);
 
         return r;
     }
@@ -1,7 +1,6 @@
 #include "base_parser.hpp"
 #include "parser_registration.hpp"
 #include <string>
-#include <sstream>
 #include <vector>
 #include <cstdint>
 #include <algorithm>
@@ -11,8 +10,10 @@
 class SevenZipParser : public BaseParser {
 public:
     std::string name() const override { return "7Z"; }
+    std::vector<uint8_t> anchorBytes() const override { return {0x37}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
+    bool match(const ByteView& blob, size_t offset) override {
         if (offset + 6 > blob.size()) return false;
         static const uint8_t sig[6] = {0x37,0x7A,0xBC,0xAF,0x27,0x1C};
         for (int i=0;i<6;i++) {
@@ -21,7 +22,7 @@ public:
         return true;
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "7Z";
@@ -51,14 +52,13 @@ public:
         r.length = computedLen;
         r.isValid = plausible;
 
-        std::ostringstream info;
-        info << "7-Zip archive, version=" << ((version>>8)&0xFF) << "." << (version&0xFF)
-             << ", nextHeaderSize=" << nextHeaderSize
-             << ", offset=" << nextHeaderOffset
-             << ", CRCs: start=0x" << std::hex << startHeaderCRC
-             << ", next=0x" << nextHeaderCRC << std::dec;
-        r.info = info.str();
-        Logger::debug(r.info);
+        r.info.text("7-Zip archive, version=").field("version_major", (version>>8)&0xFF)
+              .text(".").field("version_minor", version&0xFF)
+              .text(", nextHeaderSize=").field("next_header_size", nextHeaderSize)
+              .text(", offset=").field("next_header_offset", nextHeaderOffset)
+              .text(", CRCs: start=0x").field("start_header_crc", startHeaderCRC, InfoField::HEX)
+              .text(", next=0x").field("next_header_crc", nextHeaderCRC, InfoField::HEX);
+        Logger::debug(r.info.str());
         return r;
     }
 };
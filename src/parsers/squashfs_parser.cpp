@@ -1,6 +1,4 @@
 #include "parser_registration.hpp"
-#include <sstream>
-#include <iomanip>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -10,11 +8,14 @@
 class SquashFSParser : public BaseParser {
 public:
     std::string name() const override { return "SquashFS"; }
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override;
+    std::vector<uint8_t> anchorBytes() const override { return {'s', 'h'}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool blockAligned() const override { return true; }
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset) override;
 };
 
-bool SquashFSParser::match(const std::vector<uint8_t>& blob, size_t offset) {
+bool SquashFSParser::match(const ByteView& blob, size_t offset) {
     if (offset + 4 > blob.size()) return false;
 
     // Little-endian magic: "sqsh" (0x73717368)
@@ -32,7 +33,7 @@ bool SquashFSParser::match(const std::vector<uint8_t>& blob, size_t offset) {
     return leMagic || beMagic;
 }
 
-ScanResult SquashFSParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
+ScanResult SquashFSParser::parse(const ByteView& blob, size_t offset) {
     ScanResult result;
     result.type   = "SquashFS";
     #ifdef _WIN32
@@ -76,16 +77,14 @@ ScanResult SquashFSParser::parse(const std::vector<uint8_t>& blob, size_t offset
         endian        = "BE";
     }
 
-    std::ostringstream info;
-    info << "v" << version_major << "." << version_minor
-         << " (" << endian << ")"
-         << ", Inodes: " << inode_count
-         << ", Block: " << block_size;
+    result.info.text("v").field("version_major", version_major)
+               .text(".").field("version_minor", version_minor)
+               .text(" (").field("endianness", endian).text(")")
+               .text(", Inodes: ").field("inode_count", inode_count)
+               .text(", Block: ").field("block_size", block_size);
 
-    
     result.length = fs_size;
     result.offset = offset;
-    result.info   = info.str();
     result.isValid = true;
     return result;
 }
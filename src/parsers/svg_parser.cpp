@@ -9,51 +9,32 @@
 class SVGParser : public BaseParser {
 public:
     std::string name() const override { return "SVG"; }
+    std::vector<uint8_t> anchorBytes() const override { return {' ', '\t', '\n', '\v', '\f', '\r', '<'}; }
+    bool needsStructuredData() const override { return true; }
 
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override {
-        if (offset >= blob.size()) return false;
-
-        // Skip leading whitespace
-        size_t i = offset;
-        while (i < blob.size() && std::isspace(static_cast<unsigned char>(blob[i])))
-            ++i;
-
-        // Optional XML declaration
-        if (i + 5 < blob.size() &&
-            blob[i] == '<' && blob[i+1] == '?' &&
-            (blob[i+2] == 'x' || blob[i+2] == 'X') &&
-            (blob[i+3] == 'm' || blob[i+3] == 'M') &&
-            (blob[i+4] == 'l' || blob[i+4] == 'L')) {
-
-            // Skip until end of declaration
-            size_t declEnd = i;
-            while (declEnd + 1 < blob.size() &&
-                   !(blob[declEnd] == '?' && blob[declEnd+1] == '>'))
-                ++declEnd;
-            if (declEnd + 2 >= blob.size()) return false;
-            i = declEnd + 2;
-            while (i < blob.size() && std::isspace(static_cast<unsigned char>(blob[i])))
-                ++i;
-        }
-
-        // Now expect <svg ...>
-        if (i + 4 >= blob.size()) return false;
-        if (blob[i] != '<') return false;
-
-        auto ci = [](uint8_t c){ return static_cast<char>(std::tolower(c)); };
-
-        if (ci(blob[i+1]) != 's' || ci(blob[i+2]) != 'v' || ci(blob[i+3]) != 'g')
-            return false;
-
-        // Next char must be space, '>', '/', or newline etc.
-        uint8_t next = blob[i+4];
-        if (!(std::isspace(next) || next == '>' || next == '/'))
-            return false;
+    bool match(const ByteView& blob, size_t offset) override {
+        size_t tagStart;
+        return matchAt(blob, offset, tagStart);
+    }
 
-        return true;
+    // Every offset inside a whitespace run leads to the same tag, so a
+    // rejected candidate rules out the rest of the run as well
+    std::optional<ScanResult> probe(const ByteView& blob, size_t offset) override {
+        size_t tagStart = offset;
+        if (matchAt(blob, offset, tagStart))
+            return parse(blob, offset);
+        if (tagStart == offset)
+            return std::nullopt;
+        ScanResult r;
+        r.offset = offset;
+        r.type = "SVG";
+        r.length = 0;
+        r.isValid = false;
+        r.nextCandidate = tagStart + 1;
+        return r;
     }
 
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override {
+    ScanResult parse(const ByteView& blob, size_t offset) override {
         ScanResult r;
         r.offset = offset;
         r.type = "SVG";
@@ -123,6 +104,9 @@ public:
             r.info = "Truncated SVG (no closing </svg>)";
             r.length = blob.size() - offset;
             r.isValid = false;
+            // A later start would search a suffix of the same bytes
+            r.nextCandidate = blob.size();
+            r.needsMoreData = true;
             Logger::error("Truncated SVG");
         } else {
             r.length = endPos - offset;
@@ -132,6 +116,52 @@ public:
 
         return r;
     }
+
+private:
+    // tagStart receives the first non-whitespace offset at or after offset
+    bool matchAt(const ByteView& blob, size_t offset, size_t& tagStart) {
+        if (offset >= blob.size()) return false;
+
+        // Skip leading whitespace
+        size_t i = offset;
+        while (i < blob.size() && std::isspace(static_cast<unsigned char>(blob[i])))
+            ++i;
+        tagStart = i;
+
+        // Optional XML declaration
+        if (i + 5 < blob.size() &&
+            blob[i] == '<' && blob[i+1] == '?' &&
+            (blob[i+2] == 'x' || blob[i+2] == 'X') &&
+            (blob[i+3] == 'm' || blob[i+3] == 'M') &&
+            (blob[i+4] == 'l' || blob[i+4] == 'L')) {
+
+            // Skip until end of declaration
+            size_t declEnd = i;
+            while (declEnd + 1 < blob.size() &&
+                   !(blob[declEnd] == '?' && blob[declEnd+1] == '>'))
+                ++declEnd;
+            if (declEnd + 2 >= blob.size()) return false;
+            i = declEnd + 2;
+            while (i < blob.size() && std::isspace(static_cast<unsigned char>(blob[i])))
+                ++i;
+        }
+
+        // Now expect <svg ...>
+        if (i + 4 >= blob.size()) return false;
+        if (blob[i] != '<') return false;
+
+        auto ci = [](uint8_t c){ return static_cast<char>(std::tolower(c)); };
+
+        if (ci(blob[i+1]) != 's' || ci(blob[i+2]) != 'v' || ci(blob[i+3]) != 'g')
+            return false;
+
+        // Next char must be space, '>', '/', or newline etc.
+        uint8_t next = blob[i+4];
+        if (!(std::isspace(next) || next == '>' || next == '/'))
+            return false;
+
+        return true;
+    }
 };
 
 REGISTER_PARSER(SVGParser);
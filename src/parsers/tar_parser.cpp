@@ -5,13 +5,16 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include "byte_scan.hpp"
 
 class TARParser : public BaseParser {
 public:
     std::string name() const override { return "TAR"; }
+    bool needsStructuredData() const override { return true; }
 
-    bool match(const std::vector<std::uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<std::uint8_t>& blob, size_t offset) override;
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset) override;
+    std::optional<ScanResult> probe(const ByteView& blob, size_t offset) override;
 };
 
 static std::string read_string(const uint8_t* buf, size_t len) {
@@ -32,13 +35,40 @@ static size_t read_octal(const uint8_t* buf, size_t len) {
     return val;
 }
 
-bool TARParser::match(const std::vector<std::uint8_t>& blob, size_t offset) {
+bool TARParser::match(const ByteView& blob, size_t offset) {
     if (offset + 512 > blob.size()) return false;
     const char* magic = reinterpret_cast<const char*>(&blob[offset + 257]);
     return (std::strncmp(magic, "ustar", 5) == 0);
 }
 
-ScanResult TARParser::parse(const std::vector<std::uint8_t>& blob, size_t offset) {
+// TAR has no anchor byte and would be probed at every offset; a rejected
+// offset instead gives the next one worth probing, 257 bytes before the
+// next "ustar" in the blob
+std::optional<ScanResult> TARParser::probe(const ByteView& blob, size_t offset) {
+    if (match(blob, offset))
+        return parse(blob, offset);
+    size_t next = blob.size();
+    size_t from = offset + 258;
+    while (from + 5 <= blob.size()) {
+        size_t hit = from + find_byte_pair(blob.data() + from, blob.size() - from, 'u', 's');
+        if (hit + 5 > blob.size())
+            break;
+        if (std::memcmp(&blob[hit], "ustar", 5) == 0) {
+            next = hit - 257;
+            break;
+        }
+        from = hit + 1;
+    }
+    ScanResult r;
+    r.offset = offset;
+    r.type = "TAR";
+    r.length = 0;
+    r.isValid = false;
+    r.nextCandidate = next;
+    return r;
+}
+
+ScanResult TARParser::parse(const ByteView& blob, size_t offset) {
     ScanResult root;
     root.offset = offset;
     root.type = "TAR";
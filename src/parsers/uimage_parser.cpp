@@ -3,11 +3,15 @@
 #include <iomanip>
 #include <ctime>
 #include "../utils/helpers.hpp"
+#include "checksum.hpp"
+#include <cstring>
 class UImageParser : public BaseParser {
 public:
     std::string name() const override { return "UImage"; }
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override;
+    std::vector<uint8_t> anchorBytes() const override { return {0x27}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset) override;
 private:
 std::string get_os_name(uint8_t os);
 std::string get_arch_name(uint8_t arch);
@@ -98,14 +102,14 @@ std::string UImageParser::get_compression_type(uint8_t comp) {
 
 
 
-bool UImageParser::match(const std::vector<uint8_t>& blob, size_t offset) {
+bool UImageParser::match(const ByteView& blob, size_t offset) {
     if (offset + 4 > blob.size()) return false;
     uint32_t magic = (blob[offset] << 24) | (blob[offset + 1] << 16) |
                      (blob[offset + 2] << 8) | blob[offset + 3];
     return magic == UIMAGE_MAGIC;
 }
 
-ScanResult UImageParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
+ScanResult UImageParser::parse(const ByteView& blob, size_t offset) {
     ScanResult result;
     result.type="UIMAGE";
     result.extractorType = result.type;
@@ -129,7 +133,6 @@ uint8_t archType = blob[offset + 29];
 uint8_t imgType  = blob[offset + 30];
 uint8_t compType = blob[offset + 31];
 
-std::string timestampStr = format_timestamp(timestamp);
 // Extract image name
 std::string imageName;
 for (size_t i = 0; i < 32; ++i) {
@@ -138,8 +141,6 @@ for (size_t i = 0; i < 32; ++i) {
     imageName += c;
 }
 if (imageName.empty()) imageName = "uimage_payload";
-    std::ostringstream info;
-    std::time_t ts = timestamp;
     std::string osName   = get_os_name(osType);
 std::string archName = get_arch_name(archType);
 std::string typeName = get_image_type(imgType);
@@ -152,13 +153,25 @@ if(compName.compare("Unknown") == 0)
 }
 
 
-    info << "UImage: " + imageName 
-         << ", timestamp=" + timestampStr
-         << ", OS=" + osName +
-               ", CPU=" + archName +
-               ", Type=" + typeName +
-               ", Compression=" + compName;
-    result.info = info.str();
+    ResultInfo info;
+    info.text("UImage: ").field("name", imageName)
+        .text(", timestamp=").field("timestamp", timestamp, InfoField::TIMESTAMP)
+        .text(", OS=").field("os", osName)
+        .text(", CPU=").field("cpu", archName)
+        .text(", Type=").field("image_type", typeName)
+        .text(", Compression=").field("compression", compName);
+
+    // Header CRC covers the 64-byte header with its own field zeroed
+    uint8_t header[64];
+    std::memcpy(header, &blob[offset], sizeof(header));
+    std::memset(header + 4, 0, 4);
+    bool headerCrcOk = crc32_ieee(header, sizeof(header)) == read_be32(blob, offset + 4);
+    info.text(", header CRC ").field("header_crc", headerCrcOk ? "OK" : "mismatch");
+    if (offset + 64 + size <= blob.size())
+        info.text(", data CRC ").field("data_crc", crc32_ieee(&blob[offset + 64], size) == dataCrc ? "OK" : "mismatch");
+    else
+        info.text(", data truncated");
+    result.info = std::move(info);
     result.length = size;
     result.isValid = true;
     return result;
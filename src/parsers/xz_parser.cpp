@@ -3,9 +3,11 @@
 #include <string>
 #include "scanner.hpp"
 #include <optional>
-#include <zlib.h>
+#include "checksum.hpp"
 #include "helpers.hpp"
 #include "logger.hpp"
+#include "byte_scan.hpp"
+#include "budget.hpp"
 
 static const uint8_t XZ_MAGIC[6] = {0xFD, 0x37, 0x7A, 0x58, 0x5A, 0x00};
 static const uint8_t XZ_FOOTER_MAGIC[2] = {0x59, 0x5A}; // "YZ"
@@ -15,21 +17,23 @@ static const uint8_t XZ_FOOTER_MAGIC[2] = {0x59, 0x5A}; // "YZ"
 class XZParser : public BaseParser {
 public:
     std::string name() const override { return "XZ"; };
-    bool match(const std::vector<std::uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<std::uint8_t>& blob, size_t offset) override;
+    std::vector<uint8_t> anchorBytes() const override { return {XZ_MAGIC[0]}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset) override;
 
 private:
-    bool parse_xz_header(const std::vector<uint8_t>& data, std::size_t offset);
-    std::optional<size_t> find_xz_stream_size(const std::vector<uint8_t>& data, size_t offset);
+    bool parse_xz_header(const ByteView& data, std::size_t offset);
+    std::optional<size_t> find_xz_stream_size(const ByteView& data, size_t offset);
 };
 
-bool XZParser::match(const std::vector<std::uint8_t>& blob, size_t offset) {
+bool XZParser::match(const ByteView& blob, size_t offset) {
     if (offset + 6 > blob.size()) return false;
     return std::equal(std::begin(XZ_MAGIC), std::end(XZ_MAGIC), blob.begin() + offset);
 }
 
 // Validate the 12-byte XZ Stream Header
-bool XZParser::parse_xz_header(const std::vector<uint8_t>& data, std::size_t offset) {
+bool XZParser::parse_xz_header(const ByteView& data, std::size_t offset) {
     if (offset + 12 > data.size()) return false;
 
     if (!std::equal(std::begin(XZ_MAGIC), std::end(XZ_MAGIC), data.begin() + offset))
@@ -38,53 +42,136 @@ bool XZParser::parse_xz_header(const std::vector<uint8_t>& data, std::size_t off
     // CRC32 of bytes [6..7] (Stream Flags)
     uint32_t crc_stored = read_le32(data, offset + 8);
 
-    uint32_t crc_calc = crc32(0L, Z_NULL, 0);
-    crc_calc = crc32(crc_calc, data.data() + offset + 6, 2);
+    uint32_t crc_calc = crc32_ieee(data.data() + offset + 6, 2);
 
     return crc_stored == crc_calc;
 }
 
-// Parse XZ footer and compute full stream size
-std::optional<size_t> XZParser::find_xz_stream_size(const std::vector<uint8_t>& data, size_t offset) {
-    // Minimum XZ stream is 12-byte header + 12-byte footer
-    if (offset + 24 > data.size()) return std::nullopt;
-
-    // Footer is always last 12 bytes of the stream
-    // But we don't know where the stream ends, so we scan forward
-    size_t pos = offset + 12; // skip header
+// Size of the integrity check selected by the Stream Flags check type
+static size_t xz_check_size(uint8_t checkType) {
+    static const uint8_t sizes[16] = {0, 4, 4, 4, 8, 8, 8, 16, 16, 16, 32, 32, 32, 64, 64, 64};
+    return sizes[checkType & 0x0F];
+}
 
-    while (pos + 12 <= data.size()) {
-        // Check footer magic at pos+10..11
-        if (data[pos + 10] == XZ_FOOTER_MAGIC[0] &&
-            data[pos + 11] == XZ_FOOTER_MAGIC[1]) {
+// XZ variable-length integer (7 bits per byte, little-endian, max 9 bytes)
+static bool read_xz_varint(const ByteView& data, size_t& pos, size_t end, uint64_t& value) {
+    value = 0;
+    for (int i = 0; i < 9 && pos < end; ++i) {
+        uint8_t b = data[pos++];
+        value |= static_cast<uint64_t>(b & 0x7F) << (i * 7);
+        if (!(b & 0x80))
+            return i == 0 || b != 0;
+    }
+    return false;
+}
 
-            // Validate footer CRC
-            uint32_t crc_stored = read_le32(data, pos);
-            uint32_t crc_calc = crc32(0L, Z_NULL, 0);
-            crc_calc = crc32(crc_calc, data.data() + pos + 4, 6);
+static bool xz_crc_ok(const ByteView& data, size_t pos, size_t len, size_t crcPos) {
+    uint32_t crc_calc = crc32_ieee(data.data() + pos, len);
+    return read_le32(data, crcPos) == crc_calc;
+}
 
-            if (crc_stored != crc_calc) {
-                pos++;
-                continue;
-            }
+// Validate a Stream Footer at `pos` and return the offset of the Index it
+// points to through Backward Size.
+static std::optional<size_t> check_xz_footer(const ByteView& data, size_t streamStart, size_t pos) {
+    if (pos + 12 > data.size()) return std::nullopt;
+    if (data[pos + 10] != XZ_FOOTER_MAGIC[0] || data[pos + 11] != XZ_FOOTER_MAGIC[1])
+        return std::nullopt;
+    // Stream Flags must repeat the header's
+    if (data[pos + 8] != data[streamStart + 6] || data[pos + 9] != data[streamStart + 7])
+        return std::nullopt;
+    if (!xz_crc_ok(data, pos + 4, 6, pos))
+        return std::nullopt;
+
+    // Backward Size (in 4-byte units minus 1)
+    uint64_t index_size = (static_cast<uint64_t>(read_le32(data, pos + 4)) + 1) * 4;
+    if (index_size > pos - (streamStart + 12)) return std::nullopt;
+    size_t index = pos - static_cast<size_t>(index_size);
+    if (data[index] != 0x00) return std::nullopt;   // Index Indicator
+    return index;
+}
 
-            // Backward Size (in 4-byte units minus 1)
-            uint32_t backward_size = read_le32(data, pos + 4);
-            size_t index_size = (size_t)(backward_size + 1) * 4;
+// Walk Block Headers using their Compressed Size fields, then check the
+// Index and Footer: time is proportional to the number of blocks. Returns
+// the stream size, or nullopt if a block does not record its compressed size
+// or the structure is inconsistent.
+static std::optional<size_t> walk_xz_blocks(const ByteView& data, size_t offset) {
+    const size_t checkSize = xz_check_size(data[offset + 7]);
+    size_t pos = offset + 12;
+    uint64_t blocks = 0;
+
+    while (pos < data.size() && data[pos] != 0x00) {
+        if (!budgetOk())
+            return std::nullopt;
+        size_t headerSize = (static_cast<size_t>(data[pos]) + 1) * 4;
+        if (pos + headerSize > data.size() || !xz_crc_ok(data, pos, headerSize - 4, pos + headerSize - 4))
+            return std::nullopt;
+
+        uint8_t flags = data[pos + 1];
+        if (!(flags & 0x40))
+            return std::nullopt;   // no Compressed Size, only the footer search can size it
+        size_t field = pos + 2;
+        uint64_t compressed;
+        if (!read_xz_varint(data, field, pos + headerSize - 4, compressed) || compressed == 0)
+            return std::nullopt;
+
+        uint64_t unpadded = headerSize + compressed;
+        uint64_t next = pos + ((unpadded + 3) & ~uint64_t(3)) + checkSize;
+        if (next > data.size())
+            return std::nullopt;
+        pos = static_cast<size_t>(next);
+        ++blocks;
+    }
+    if (pos >= data.size())
+        return std::nullopt;
+
+    // Index: indicator, record count, records, padding, CRC32
+    size_t index = pos;
+    size_t cur = index + 1;
+    uint64_t records;
+    if (!read_xz_varint(data, cur, data.size(), records) || records != blocks)
+        return std::nullopt;
+    for (uint64_t i = 0; i < records; ++i) {
+        uint64_t unpadded, uncompressed;
+        if (!read_xz_varint(data, cur, data.size(), unpadded) ||
+            !read_xz_varint(data, cur, data.size(), uncompressed))
+            return std::nullopt;
+    }
+    cur = index + ((cur - index + 3) & ~size_t(3));
+    if (cur + 4 > data.size() || !xz_crc_ok(data, index, cur - index, cur))
+        return std::nullopt;
+
+    size_t footer = cur + 4;
+    auto indexFromFooter = check_xz_footer(data, offset, footer);
+    if (!indexFromFooter || *indexFromFooter != index)
+        return std::nullopt;
+    return footer + 12 - offset;
+}
 
-            // Full stream size = header + blocks + index + footer
-            size_t stream_size = (pos - offset) + 12;
+// Parse XZ footer and compute full stream size
+std::optional<size_t> XZParser::find_xz_stream_size(const ByteView& data, size_t offset) {
+    // Minimum XZ stream is 12-byte header + 12-byte footer
+    if (offset + 24 > data.size()) return std::nullopt;
 
-            return stream_size;
-        }
+    if (auto size = walk_xz_blocks(data, offset))
+        return size;
 
-        pos++;
+    // Fallback for streams whose blocks omit Compressed Size: search for the
+    // footer magic and accept it only if Backward Size leads to an Index.
+    size_t pos = offset + 12 + 10;
+    while (pos + 2 <= data.size() && budgetOk()) {
+        size_t hit = pos + find_byte_pair(data.data() + pos, data.size() - pos,
+                                          XZ_FOOTER_MAGIC[0], XZ_FOOTER_MAGIC[1]);
+        if (hit + 2 > data.size())
+            break;
+        if (check_xz_footer(data, offset, hit - 10))
+            return hit + 2 - offset;
+        pos = hit + 1;
     }
 
     return std::nullopt;
 }
 
-ScanResult XZParser::parse(const std::vector<std::uint8_t>& blob, size_t offset) {
+ScanResult XZParser::parse(const ByteView& blob, size_t offset) {
     ScanResult result;
     result.offset = offset;
     result.length = 0;
@@ -96,7 +183,7 @@ ScanResult XZParser::parse(const std::vector<std::uint8_t>& blob, size_t offset)
     size_t nextOffset = offset;
     size_t streamCount = 0;
 
-    while (nextOffset < blob.size()) {
+    while (nextOffset < blob.size() && budgetOk()) {
         if (!parse_xz_header(blob, nextOffset))
             break;
 
@@ -105,16 +192,20 @@ ScanResult XZParser::parse(const std::vector<std::uint8_t>& blob, size_t offset)
             break;
 
         size_t streamSize = *sizeOpt;
-        result.length += streamSize;
+        result.length = nextOffset + streamSize - offset;
         nextOffset += streamSize;
         streamCount++;
+
+        // Stream Padding: multiples of four null bytes between streams
+        while (nextOffset + 4 <= blob.size() && read_le32(blob, nextOffset) == 0)
+            nextOffset += 4;
     }
 
     result.isValid = (streamCount > 0);
 
     if (result.isValid) {
-        result.info += ", streams=" + std::to_string(streamCount) +
-                       ", total size=" + std::to_string(result.length) + " bytes";
+        result.info.text(", streams=").field("streams", streamCount)
+                   .text(", total size=").field("size", result.length).text(" bytes");
     }
 
     return result;
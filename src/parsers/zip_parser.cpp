@@ -5,29 +5,30 @@
 #include <cstring>
 #include <string>
 #include <vector>
-#include <sstream>
 #include <algorithm>
 
 class ZIPParser : public BaseParser {
 public:
     std::string name() const override { return "ZIP"; }
-    bool match(const std::vector<uint8_t>& blob, size_t offset) override;
-    ScanResult parse(const std::vector<uint8_t>& blob, size_t offset) override;
+    std::vector<uint8_t> anchorBytes() const override { return {'P'}; }
+    ProbeTier probeTier() const override { return ProbeTier::Magic; }
+    bool match(const ByteView& blob, size_t offset) override;
+    ScanResult parse(const ByteView& blob, size_t offset) override;
 
 private:
-    size_t findEndOfCentralDirectory(const std::vector<uint8_t>& blob, size_t zipBase);
-    uint16_t extractFileCount(const std::vector<uint8_t>& blob, size_t eocdEnd);
-    bool validateCRCForSomeEntries(const std::vector<uint8_t>& blob,
+    size_t findEndOfCentralDirectory(const ByteView& blob, size_t zipBase, bool& sawSignature);
+    uint16_t extractFileCount(const ByteView& blob, size_t eocdEnd);
+    bool validateCRCForSomeEntries(const ByteView& blob,
                                    size_t zipBase,
                                    size_t cdStart,
                                    size_t cdEnd,
                                    unsigned maxEntriesToCheck = 5);
-    bool validateCRCEntry(const std::vector<uint8_t>& blob,
+    bool validateCRCEntry(const ByteView& blob,
                           size_t zipBase,
                           size_t cdEntryOffset);
 };
 
-bool ZIPParser::match(const std::vector<uint8_t>& blob, size_t offset) {
+bool ZIPParser::match(const ByteView& blob, size_t offset) {
     // Local file header signatures: PK 03 04, PK 05 06, PK 07 08
     if (offset + 4 > blob.size()) return false;
 
@@ -47,7 +48,7 @@ bool ZIPParser::match(const std::vector<uint8_t>& blob, size_t offset) {
     return false;
 }
 
-ScanResult ZIPParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
+ScanResult ZIPParser::parse(const ByteView& blob, size_t offset) {
     ScanResult result;
     result.type = "ZIP";
     result.extractorType = "7Z";
@@ -61,22 +62,30 @@ ScanResult ZIPParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
         return result;
     }
 
-    size_t eocdEnd = findEndOfCentralDirectory(blob, offset);
+    bool sawSignature = false;
+    size_t eocdEnd = findEndOfCentralDirectory(blob, offset, sawSignature);
     if (eocdEnd <= offset || eocdEnd > blob.size()) {
         // No EOCD found that structurally matches this ZIP start
         result.info = "No valid EOCD found for ZIP at offset";
+        // Without any EOCD signature ahead, no later start can succeed either,
+        // unless the archive continues past the end of the blob
+        if (!sawSignature) {
+            result.nextCandidate = blob.size();
+            result.needsMoreData = true;
+        }
         return result;
     }
 
     size_t length = eocdEnd - offset;
     uint16_t count = extractFileCount(blob, eocdEnd);
 
-    std::ostringstream info;
-    info << "ZIP archive, files=" << count << ", size=" << length << " bytes";
+    ResultInfo info;
+    info.text("ZIP archive, files=").field("files", count)
+        .text(", size=").field("size", length).text(" bytes");
 
     result.length = length;
     result.isValid = true;
-    result.info = info.str();
+    result.info = std::move(info);
 
     return result;
 }
@@ -85,7 +94,7 @@ ScanResult ZIPParser::parse(const std::vector<uint8_t>& blob, size_t offset) {
 // EOCD signature: 50 4B 05 06
 // EOCD must be within maxSearch bytes of zipBase; we verify central directory
 // location and optionally CRC consistency to avoid false positives.
-size_t ZIPParser::findEndOfCentralDirectory(const std::vector<uint8_t>& blob, size_t zipBase) {
+size_t ZIPParser::findEndOfCentralDirectory(const ByteView& blob, size_t zipBase, bool& sawSignature) {
     const uint8_t sig[4] = {0x50, 0x4B, 0x05, 0x06};
 
     if (blob.size() < zipBase + 22)
@@ -99,6 +108,7 @@ size_t ZIPParser::findEndOfCentralDirectory(const std::vector<uint8_t>& blob, si
             blob[i + 3] == sig[3]) {
 
             // We found EOCD signature candidate.
+            sawSignature = true;
             if (i + 22 > blob.size())
                 continue;
 
@@ -148,7 +158,7 @@ size_t ZIPParser::findEndOfCentralDirectory(const std::vector<uint8_t>& blob, si
     return blob.size();
 }
 
-uint16_t ZIPParser::extractFileCount(const std::vector<uint8_t>& blob, size_t eocdEnd) {
+uint16_t ZIPParser::extractFileCount(const ByteView& blob, size_t eocdEnd) {
     if (eocdEnd < 22 || eocdEnd > blob.size())
         return 0;
 
@@ -175,7 +185,7 @@ uint16_t ZIPParser::extractFileCount(const std::vector<uint8_t>& blob, size_t eo
 // Walk a few central directory entries and check CRC consistency between
 // the central directory entry and the local file header.
 // We don't need to check them all; a handful is enough to strongly confirm.
-bool ZIPParser::validateCRCForSomeEntries(const std::vector<uint8_t>& blob,
+bool ZIPParser::validateCRCForSomeEntries(const ByteView& blob,
                                           size_t zipBase,
                                           size_t cdStart,
                                           size_t cdEnd,
@@ -228,7 +238,7 @@ bool ZIPParser::validateCRCForSomeEntries(const std::vector<uint8_t>& blob,
 
 // Validate a single central directory entry against its local file header CRC.
 // This does NOT verify the actual data, only consistency between CD and LFH.
-bool ZIPParser::validateCRCEntry(const std::vector<uint8_t>& blob,
+bool ZIPParser::validateCRCEntry(const ByteView& blob,
                                  size_t zipBase,
                                  size_t cdEntryOffset)
 {
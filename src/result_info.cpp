@@ -0,0 +1,82 @@
+#include "result_info.hpp"
+#include "helpers.hpp"
+#include <charconv>
+
+std::string InfoField::render() const {
+    std::string out;
+    renderTo(out);
+    return out;
+}
+
+void InfoField::renderTo(std::string& out) const {
+    char buf[24];
+    switch (format) {
+    case DECIMAL:
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), number).ptr);
+        break;
+    case SIGNED:
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), static_cast<int64_t>(number)).ptr);
+        break;
+    case HEX:
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), number, 16).ptr);
+        break;
+    case TIMESTAMP:
+        out += format_timestamp(static_cast<uint32_t>(number));
+        break;
+    case TEXT:
+    default:
+        out += text;
+        break;
+    }
+}
+
+ResultInfo& ResultInfo::operator=(std::string text) {
+    layout = std::move(text);
+    fields.clear();
+    return *this;
+}
+
+ResultInfo& ResultInfo::text(std::string_view text) {
+    layout.append(text.data(), text.size());
+    return *this;
+}
+
+ResultInfo& ResultInfo::field(const char* key, uint64_t value, InfoField::Format format) {
+    InfoField f;
+    f.key = key;
+    f.format = format;
+    f.at = static_cast<uint32_t>(layout.size());
+    f.number = value;
+    fields.push_back(std::move(f));
+    return *this;
+}
+
+ResultInfo& ResultInfo::field(const char* key, std::string value) {
+    InfoField f;
+    f.key = key;
+    f.format = InfoField::TEXT;
+    f.at = static_cast<uint32_t>(layout.size());
+    f.text = std::move(value);
+    fields.push_back(std::move(f));
+    return *this;
+}
+
+ResultInfo& ResultInfo::add(InfoField field) {
+    fields.push_back(std::move(field));
+    return *this;
+}
+
+std::string ResultInfo::render(std::string_view layout, const InfoField* fields, size_t count) {
+    std::string out;
+    out.reserve(layout.size() + 16 * count);
+    size_t pos = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (fields[i].at == InfoField::NOT_IN_TEXT)
+            continue;
+        out.append(layout.substr(pos, fields[i].at - pos));
+        fields[i].renderTo(out);
+        pos = fields[i].at;
+    }
+    out.append(layout.substr(pos));
+    return out;
+}
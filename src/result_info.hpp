@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A decoded value that a result's info text mentions
+struct InfoField {
+    enum Format : uint8_t {
+        DECIMAL,    // number
+        SIGNED,     // number, holds an int64_t
+        HEX,        // number, lower-case hex digits without prefix
+        TEXT,       // text
+        TIMESTAMP,  // number, seconds since the epoch as "YYYY-MM-DD HH:MM:SS UTC"
+    };
+    static constexpr uint32_t NOT_IN_TEXT = 0xFFFFFFFFu;
+
+    const char* key = "";   // JSON name, a string literal or interned
+    Format format = DECIMAL;
+    uint32_t at = NOT_IN_TEXT;  // where the value goes in the text
+    uint64_t number = 0;
+    std::string text;
+
+    std::string render() const;
+    void renderTo(std::string& out) const;
+};
+
+// The info text of a result as literal text plus typed fields, rendered
+// only when it is read. Parsers record the values they decoded instead of
+// formatting them, so candidates that are rejected or ignored cost no
+// number, CRC or timestamp formatting; JSON output writes the fields as an
+// object next to the text.
+//
+//   r.info.text("GZIP stream, compression method=").field("compression_method", cm)
+//         .text(", flags=0x").field("flags", flg, InfoField::HEX);
+class ResultInfo {
+public:
+    // Plain text, without fields
+    ResultInfo& operator=(std::string text);
+    ResultInfo& operator+=(std::string_view text) { return this->text(text); }
+
+    ResultInfo& text(std::string_view text);
+    ResultInfo& field(const char* key, uint64_t value, InfoField::Format format = InfoField::DECIMAL);
+    ResultInfo& field(const char* key, std::string value);
+    // A field with its position already set, e.g. a copy
+    ResultInfo& add(InfoField field);
+
+    bool empty() const { return layout.empty() && fields.empty(); }
+    std::string str() const { return render(layout, fields.data(), fields.size()); }
+    // Literal text; fields are inserted at their `at` offsets
+    const std::string& literal() const { return layout; }
+    const std::vector<InfoField>& values() const { return fields; }
+
+    static std::string render(std::string_view layout, const InfoField* fields, size_t count);
+
+private:
+    std::string layout;
+    std::vector<InfoField> fields;
+};
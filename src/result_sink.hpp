@@ -0,0 +1,14 @@
+#pragma once
+#include "result_store.hpp"
+#include <string>
+
+// Receives top-level results while Scanner::scan is still running, so output
+// can be produced as soon as a result (and its extracted children) is complete.
+// The view points into the scanner's ResultStore.
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+    virtual void beginScan(const std::string&) {}
+    virtual void onResult(const ResultView& result) = 0;
+    virtual void endScan() {}
+};
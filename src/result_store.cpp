@@ -0,0 +1,265 @@
+#include "result_store.hpp"
+#include <algorithm>
+
+static uint8_t flagsOf(const ScanResult& r) {
+    return (r.isValid ? ResultStore::VALID : 0) |
+           (r.confident ? ResultStore::CONFIDENT : 0) |
+           (r.extracted ? ResultStore::EXTRACTED : 0) |
+           (r.budgetExceeded ? ResultStore::BUDGET_EXCEEDED : 0);
+}
+
+static void putVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+static uint64_t getVarint(const char*& p) {
+    uint64_t v = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*p++);
+        v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return v;
+    }
+}
+
+std::string ResultView::info() const {
+    return store->renderInfo(index);
+}
+
+std::vector<InfoField> ResultView::fields() const {
+    return store->infoOf(index).values();
+}
+
+ScanResult ResultView::toResult() const {
+    ScanResult r;
+    r.offset = offset();
+    r.length = length();
+    r.type = std::string(type());
+    r.extractorType = std::string(extractorType());
+    r.info = store->infoOf(index);
+    r.source = std::string(source());
+    r.isValid = isValid();
+    r.confident = confident();
+    r.extracted = extracted();
+    r.budgetExceeded = budgetExceeded();
+    return r;
+}
+
+ResultStore::ResultStore() {
+    names.emplace_back();
+    nameIds.emplace(std::string(), 0);
+}
+
+void ResultStore::clear() {
+    *this = ResultStore();
+}
+
+uint32_t ResultStore::intern(std::string_view name) {
+    if (name.empty())
+        return 0;
+    auto it = nameIds.find(std::string(name));
+    if (it != nameIds.end())
+        return it->second;
+    uint32_t id = static_cast<uint32_t>(names.size());
+    names.emplace_back(name);
+    nameIds.emplace(names.back(), id);
+    return id;
+}
+
+void ResultStore::link(ResultId id, ResultId parent) {
+    parents.push_back(parent);
+    firstChildren.push_back(NO_RESULT);
+    lastChildren.push_back(NO_RESULT);
+    nextSiblings.push_back(NO_RESULT);
+    ResultId& first = parent == NO_RESULT ? firstRoot : firstChildren[parent];
+    ResultId& last = parent == NO_RESULT ? lastRoot : lastChildren[parent];
+    if (last == NO_RESULT)
+        first = id;
+    else
+        nextSiblings[last] = id;
+    last = id;
+    if (parent == NO_RESULT)
+        ++roots;
+}
+
+// The literal text, then per field: key, format, position + 1 (0: not in
+// the text) and the number, or the length and bytes of a text value
+void ResultStore::setInfo(ResultId id, const ResultInfo& info) {
+    const std::string& literal = info.literal();
+    size_t count = std::min<size_t>(info.values().size(), UINT16_MAX);
+    infoOffsets[id] = infoPool.size();
+    infoLengths[id] = static_cast<uint32_t>(literal.size());
+    fieldCounts[id] = static_cast<uint16_t>(count);
+    infoPool += literal;
+    for (size_t i = 0; i < count; ++i) {
+        const InfoField& f = info.values()[i];
+        putVarint(infoPool, internKey(f.key));
+        infoPool.push_back(static_cast<char>(f.format));
+        putVarint(infoPool, f.at == InfoField::NOT_IN_TEXT ? 0 : uint64_t(f.at) + 1);
+        if (f.format == InfoField::TEXT) {
+            putVarint(infoPool, f.text.size());
+            infoPool += f.text;
+        } else {
+            putVarint(infoPool, f.number);
+        }
+    }
+}
+
+uint32_t ResultStore::internKey(const char* key) {
+    auto it = keyIds.find(key);
+    if (it != keyIds.end() && names[it->second] == key)
+        return it->second;
+    uint32_t id = intern(key);
+    keyIds[key] = id;
+    return id;
+}
+
+std::string ResultStore::renderInfo(ResultId id) const {
+    std::string_view layout = std::string_view(infoPool).substr(infoOffsets[id], infoLengths[id]);
+    if (fieldCounts[id] == 0)
+        return std::string(layout);
+    std::string out;
+    const char* p = layout.data() + layout.size();
+    size_t pos = 0;
+    InfoField f;
+    for (uint16_t i = 0; i < fieldCounts[id]; ++i) {
+        getVarint(p);  // key
+        f.format = static_cast<InfoField::Format>(*p++);
+        uint64_t at = getVarint(p);
+        if (f.format == InfoField::TEXT) {
+            size_t length = getVarint(p);
+            f.text.assign(p, length);
+            p += length;
+        } else {
+            f.number = getVarint(p);
+        }
+        if (at == 0)
+            continue;
+        out.append(layout.substr(pos, at - 1 - pos));
+        f.renderTo(out);
+        pos = at - 1;
+    }
+    out.append(layout.substr(pos));
+    return out;
+}
+
+ResultInfo ResultStore::infoOf(ResultId id) const {
+    ResultInfo info;
+    info = infoPool.substr(infoOffsets[id], infoLengths[id]);
+    const char* p = infoPool.data() + infoOffsets[id] + infoLengths[id];
+    for (uint16_t i = 0; i < fieldCounts[id]; ++i) {
+        InfoField f;
+        f.key = names[getVarint(p)].c_str();
+        f.format = static_cast<InfoField::Format>(*p++);
+        uint64_t at = getVarint(p);
+        f.at = at ? static_cast<uint32_t>(at - 1) : InfoField::NOT_IN_TEXT;
+        if (f.format == InfoField::TEXT) {
+            size_t length = getVarint(p);
+            f.text.assign(p, length);
+            p += length;
+        } else {
+            f.number = getVarint(p);
+        }
+        info.add(std::move(f));
+    }
+    return info;
+}
+
+ResultId ResultStore::add(const ScanResult& result, ResultId parent, uint32_t source) {
+    ResultId id = reserve(parent, source);
+    update(id, result);
+    return id;
+}
+
+// Nothing goes into infoPool until the result is known, the pool is
+// append-only and a placeholder's info would stay in it for good
+ResultId ResultStore::reserve(ResultId parent, uint32_t source) {
+    ResultId id = static_cast<ResultId>(size());
+    offsets.push_back(0);
+    lengths.push_back(0);
+    types.push_back(0);
+    extractors.push_back(0);
+    sources.push_back(source);
+    infoOffsets.push_back(0);
+    infoLengths.push_back(0);
+    fieldCounts.push_back(0);
+    flags.push_back(0);
+    link(id, parent);
+    return id;
+}
+
+ResultId ResultStore::add(const ScanResult& result, ResultId parent) {
+    return add(result, parent, intern(result.source));
+}
+
+void ResultStore::update(ResultId id, const ScanResult& result) {
+    offsets[id] = result.offset;
+    lengths[id] = result.length;
+    types[id] = intern(result.type);
+    extractors[id] = intern(result.extractorType);
+    flags[id] = flagsOf(result);
+    setInfo(id, result.info);
+}
+
+// Appends result `i` of `from` with its strings and fields, `nameMap`
+// translating the names of `from` into this store
+void ResultStore::copy(const ResultStore& from, ResultId i, const std::vector<uint32_t>& nameMap,
+                       uint32_t source, ResultId parent) {
+    ResultId id = static_cast<ResultId>(size());
+    offsets.push_back(from.offsets[i]);
+    lengths.push_back(from.lengths[i]);
+    types.push_back(nameMap[from.types[i]]);
+    extractors.push_back(nameMap[from.extractors[i]]);
+    sources.push_back(source);
+    infoOffsets.push_back(0);
+    infoLengths.push_back(0);
+    fieldCounts.push_back(0);
+    flags.push_back(from.flags[i]);
+    if (from.fieldCounts[i] == 0) {
+        infoOffsets[id] = infoPool.size();
+        infoLengths[id] = from.infoLengths[i];
+        infoPool.append(from.infoPool, from.infoOffsets[i], from.infoLengths[i]);
+    } else {
+        // Field keys are names of `from` and are interned again
+        setInfo(id, from.infoOf(i));
+    }
+    link(id, parent);
+}
+
+void ResultStore::append(const ResultStore& other, ResultId parent, uint32_t source) {
+    // Both stores are in pre-order, so a parent is always copied before
+    // its children and its new id is known by then
+    ResultId base = static_cast<ResultId>(size());
+    std::vector<uint32_t> nameMap(other.names.size());
+    for (size_t i = 0; i < other.names.size(); ++i)
+        nameMap[i] = intern(other.names[i]);
+    for (ResultId i = 0; i < other.size(); ++i) {
+        bool root = other.parents[i] == NO_RESULT;
+        copy(other, i, nameMap, root && source != NO_RESULT ? source : nameMap[other.sources[i]],
+             root ? parent : base + other.parents[i]);
+    }
+}
+
+ResultStore ResultStore::slice(ResultId first) const {
+    // The results after `first` are whole subtrees in pre-order; parents
+    // before `first` become the top level of the copy
+    ResultStore out;
+    std::vector<uint32_t> nameMap(names.size(), 0);
+    auto use = [&](uint32_t name) {
+        if (name && !nameMap[name])
+            nameMap[name] = out.intern(names[name]);
+    };
+    for (ResultId i = first; i < size(); ++i) {
+        use(types[i]);
+        use(extractors[i]);
+        use(sources[i]);
+    }
+    for (ResultId i = first; i < size(); ++i)
+        out.copy(*this, i, nameMap, nameMap[sources[i]],
+                 parents[i] == NO_RESULT || parents[i] < first ? NO_RESULT : parents[i] - first);
+    return out;
+}
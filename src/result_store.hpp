@@ -0,0 +1,182 @@
+#pragma once
+#include "scanresult.hpp"
+#include "result_info.hpp"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using ResultId = uint32_t;
+constexpr ResultId NO_RESULT = 0xFFFFFFFFu;
+
+class ResultStore;
+
+// Read-only handle to one result of a ResultStore: the store and an index,
+// cheap to copy and valid while the store exists, also when it grows.
+// The strings it returns point into the store.
+class ResultView {
+public:
+    class Iterator {
+    public:
+        Iterator(const ResultStore* store, ResultId id) : store(store), id(id) {}
+        ResultView operator*() const { return ResultView(store, id); }
+        Iterator& operator++();
+        bool operator!=(const Iterator& other) const { return id != other.id; }
+
+    private:
+        const ResultStore* store;
+        ResultId id;
+    };
+
+    // Siblings linked from `first`, e.g. the children of a result
+    class Range {
+    public:
+        Range(const ResultStore* store, ResultId first) : store(store), first(first) {}
+        Iterator begin() const { return Iterator(store, first); }
+        Iterator end() const { return Iterator(store, NO_RESULT); }
+        bool empty() const { return first == NO_RESULT; }
+
+    private:
+        const ResultStore* store;
+        ResultId first;
+    };
+
+    ResultView(const ResultStore* store, ResultId id) : store(store), index(id) {}
+
+    ResultId id() const { return index; }
+    ResultId parent() const;  // NO_RESULT for top-level results
+    uint64_t offset() const;
+    uint64_t length() const;
+    std::string_view type() const;
+    std::string_view extractorType() const;
+    // Renders the info text with its fields
+    std::string info() const;
+    size_t fieldCount() const;
+    std::vector<InfoField> fields() const;
+    std::string_view source() const;
+    bool isValid() const;
+    bool confident() const;
+    bool extracted() const;
+    bool budgetExceeded() const;
+
+    Range children() const;
+    bool hasChildren() const;
+    bool isLastSibling() const;
+
+    // A copy as a plain ScanResult, without the children
+    ScanResult toResult() const;
+
+private:
+    const ResultStore* store;
+    ResultId index;
+};
+
+// All results of a scan in one arena: fixed-size records in parallel
+// vectors, the tree as parent/child/sibling indices, the type, extractor
+// and source names interned once and the info texts in an append-only
+// pool, each followed by its typed fields as varints. Scanners append their
+// results here, nested scanners into the store of the top-level one, so a
+// result costs a few dozen bytes and no allocation of its own however deep
+// it sits.
+//
+// Results are appended in depth-first pre-order: a result is added before
+// the results found in what was extracted from it.
+class ResultStore {
+public:
+    enum Flags : uint8_t {
+        VALID           = 1u << 0,
+        CONFIDENT       = 1u << 1,
+        EXTRACTED       = 1u << 2,
+        BUDGET_EXCEEDED = 1u << 3,
+    };
+
+    ResultStore();
+
+    // Appends `result` as the last child of `parent` (NO_RESULT: a top-level
+    // result). `source` is an interned name, see intern().
+    ResultId add(const ScanResult& result, ResultId parent, uint32_t source);
+    ResultId add(const ScanResult& result, ResultId parent = NO_RESULT);
+    // Appends an empty result as a placeholder for one whose children are
+    // added before the result itself is final, see update()
+    ResultId reserve(ResultId parent, uint32_t source);
+    // Rewrites the fields of a result added or reserved before, keeping its
+    // place in the tree
+    void update(ResultId id, const ScanResult& result);
+    // Copies every result of `other` below `parent`. The top-level results
+    // of `other` get `source` unless it is NO_RESULT.
+    void append(const ResultStore& other, ResultId parent, uint32_t source = NO_RESULT);
+    // The results added since `first` (the subtrees of one scanned blob) as
+    // a store of their own
+    ResultStore slice(ResultId first) const;
+
+    uint32_t intern(std::string_view name);
+    std::string_view name(uint32_t id) const { return names[id]; }
+
+    size_t size() const { return offsets.size(); }
+    bool empty() const { return offsets.empty(); }
+    size_t rootCount() const { return roots; }
+    ResultView operator[](ResultId id) const { return ResultView(this, id); }
+    ResultView::Range topLevel() const { return ResultView::Range(this, firstRoot); }
+
+    void clear();
+
+private:
+    friend class ResultView;
+
+    void link(ResultId id, ResultId parent);
+    void copy(const ResultStore& from, ResultId i, const std::vector<uint32_t>& nameMap,
+              uint32_t source, ResultId parent);
+    void setInfo(ResultId id, const ResultInfo& info);
+    // The info of result `id`; the field keys point into `names`
+    ResultInfo infoOf(ResultId id) const;
+    std::string renderInfo(ResultId id) const;
+    uint32_t internKey(const char* key);
+
+    // One entry per result
+    std::vector<uint64_t> offsets;
+    std::vector<uint64_t> lengths;
+    std::vector<uint32_t> types;        // interned names
+    std::vector<uint32_t> extractors;   // interned names, 0 = none
+    std::vector<uint32_t> sources;      // interned names
+    std::vector<uint64_t> infoOffsets;  // literal info text in infoPool,
+    std::vector<uint32_t> infoLengths;  // the fields right after it
+    std::vector<uint16_t> fieldCounts;
+    std::vector<uint8_t> flags;         // Flags
+    std::vector<ResultId> parents;
+    std::vector<ResultId> firstChildren;
+    std::vector<ResultId> lastChildren;
+    std::vector<ResultId> nextSiblings;
+
+    ResultId firstRoot = NO_RESULT;
+    ResultId lastRoot = NO_RESULT;
+    size_t roots = 0;
+
+    std::string infoPool;
+    std::deque<std::string> names;  // id 0 is the empty name; a deque, views into it stay valid
+    std::unordered_map<std::string, uint32_t> nameIds;
+    // Field keys are mostly string literals; a pointer seen before is
+    // checked against the name it was interned as
+    std::unordered_map<const char*, uint32_t> keyIds;
+};
+
+inline ResultId ResultView::parent() const { return store->parents[index]; }
+inline uint64_t ResultView::offset() const { return store->offsets[index]; }
+inline uint64_t ResultView::length() const { return store->lengths[index]; }
+inline std::string_view ResultView::type() const { return store->names[store->types[index]]; }
+inline std::string_view ResultView::extractorType() const { return store->names[store->extractors[index]]; }
+inline std::string_view ResultView::source() const { return store->names[store->sources[index]]; }
+inline size_t ResultView::fieldCount() const { return store->fieldCounts[index]; }
+inline bool ResultView::isValid() const { return store->flags[index] & ResultStore::VALID; }
+inline bool ResultView::confident() const { return store->flags[index] & ResultStore::CONFIDENT; }
+inline bool ResultView::extracted() const { return store->flags[index] & ResultStore::EXTRACTED; }
+inline bool ResultView::budgetExceeded() const { return store->flags[index] & ResultStore::BUDGET_EXCEEDED; }
+inline ResultView::Range ResultView::children() const { return Range(store, store->firstChildren[index]); }
+inline bool ResultView::hasChildren() const { return store->firstChildren[index] != NO_RESULT; }
+inline bool ResultView::isLastSibling() const { return store->nextSiblings[index] == NO_RESULT; }
+
+inline ResultView::Iterator& ResultView::Iterator::operator++() {
+    id = store->nextSiblings[id];
+    return *this;
+}
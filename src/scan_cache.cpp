@@ -0,0 +1,141 @@
+#include "scan_cache.hpp"
+#include "parser_registry.hpp"
+#include "scan_index.hpp"
+#include "hash.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+// Bump when parser behaviour changes in a way that invalidates cached results
+static constexpr uint32_t PARSER_LOGIC_REVISION = 3;
+
+ScanCache::ScanCache(fs::path directory, bool useSha256)
+    : directory(std::move(directory)), useSha256(useSha256) {
+    if (this->directory.empty())
+        return;
+    std::error_code ec;
+    fs::create_directories(this->directory, ec);
+    if (ec)
+        Logger::error("Cannot create cache directory " + this->directory.string());
+}
+
+void ScanCache::keepInMemory(size_t entries) {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    memoryEntries = entries;
+    while (memory.size() > memoryEntries) {
+        memoryIndex.erase(memory.back().first);
+        memory.pop_back();
+    }
+}
+
+uint32_t ScanCache::parserSetVersion() {
+    static const uint32_t version = [] {
+        std::vector<std::string> names;
+        for (const auto& parser : ParserRegistry::instance().createAll())
+            names.push_back(parser->name());
+        std::sort(names.begin(), names.end());
+
+        XXHash64 h(PARSER_LOGIC_REVISION);
+        for (const auto& name : names)
+            h.update(reinterpret_cast<const uint8_t*>(name.c_str()), name.size() + 1);
+        uint64_t digest = h.digest();
+        return static_cast<uint32_t>(digest ^ (digest >> 32));
+    }();
+    return version;
+}
+
+std::string ScanCache::key(const ByteView& blob, uint64_t hash, const std::string& options) const {
+    std::string digest;
+    if (useSha256) {
+        auto d = sha256(blob.data(), blob.size());
+        digest = hex_digest(d.data(), d.size());
+    } else {
+        digest = hex_digest(hash);
+    }
+    return digest + "-" + hex_digest(parserSetVersion()).substr(8) + "-" + options;
+}
+
+fs::path ScanCache::entryPath(const std::string& key) const {
+    return directory / (key + ".hdx");
+}
+
+bool ScanCache::loadMemory(const std::string& key, size_t inputSize, ResultStore& out) const {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    auto it = memoryIndex.find(key);
+    if (it == memoryIndex.end() || it->second->second.inputSize != inputSize)
+        return false;
+    memory.splice(memory.begin(), memory, it->second);
+    out = it->second->second.results;
+    return true;
+}
+
+void ScanCache::storeMemory(const std::string& key, size_t inputSize, const ResultStore& results) const {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    if (memoryEntries == 0)
+        return;
+    auto it = memoryIndex.find(key);
+    if (it != memoryIndex.end()) {
+        memory.erase(it->second);
+        memoryIndex.erase(it);
+    }
+    memory.emplace_front(key, MemoryEntry{inputSize, results});
+    memoryIndex[key] = memory.begin();
+    if (memory.size() > memoryEntries) {
+        memoryIndex.erase(memory.back().first);
+        memory.pop_back();
+    }
+}
+
+bool ScanCache::load(const std::string& key, const ByteView& blob, ResultStore& out) const {
+    if (loadMemory(key, blob.size(), out)) {
+        Logger::debug("Memory cache hit " + key);
+        return true;
+    }
+    if (directory.empty())
+        return false;
+    fs::path path = entryPath(key);
+    std::error_code ec;
+    if (!fs::exists(path, ec))
+        return false;
+
+    ScanIndexReader index;
+    if (!index.open(path))
+        return false;
+
+    // Cheap guard against truncated or foreign entries
+    const HdxHeader& h = index.header();
+    if (h.inputSize != blob.size() || h.parserSet != parserSetVersion())
+        return false;
+
+    if (!index.toResults(out))
+        return false;
+    Logger::debug("Cache hit " + key);
+    storeMemory(key, blob.size(), out);
+    return true;
+}
+
+void ScanCache::store(const std::string& key, const ByteView& blob, uint64_t hash,
+                      const std::string& inputName, const ResultStore& results) const {
+    storeMemory(key, blob.size(), results);
+    if (directory.empty())
+        return;
+    ScanIndexMeta meta;
+    meta.inputName = inputName;
+    meta.inputSize = blob.size();
+    meta.inputHash = hash;
+    meta.parserSet = parserSetVersion();
+
+    // Write to a temporary name first so concurrent readers never see a partial entry
+    fs::path path = entryPath(key);
+    // (the name is per thread, batch scans can store the same entry twice)
+    fs::path tmp = path;
+    tmp += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    if (!writeScanIndex(results, meta, tmp))
+        return;
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec)
+        fs::remove(tmp, ec);
+}
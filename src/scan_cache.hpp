@@ -0,0 +1,55 @@
+#pragma once
+#include "byte_view.hpp"
+#include "result_store.hpp"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// On-disk cache of scan results keyed by the content hash of the scanned
+// data plus the parser-set version, so identical blobs (across runs and
+// across the jobs of a server) are only scanned once. Entries are stored as
+// .hdx scan index files. Optionally the most recently used entries are also
+// kept in memory, for long-running processes that see the same content
+// again; an empty directory makes the cache memory-only. Scans that extract
+// do not use it. Safe to share between threads.
+class ScanCache {
+public:
+    explicit ScanCache(fs::path directory, bool useSha256 = false);
+
+    // Keeps up to `entries` results in memory, 0 disables the memory tier
+    void keepInMemory(size_t entries);
+
+    // `hash` is the XXH64 of the blob, `options` identifies the scan settings
+    // that influence the results
+    std::string key(const ByteView& blob, uint64_t hash, const std::string& options) const;
+    bool load(const std::string& key, const ByteView& blob, ResultStore& out) const;
+    void store(const std::string& key, const ByteView& blob, uint64_t hash,
+               const std::string& inputName, const ResultStore& results) const;
+
+    // Changes whenever the set of registered parsers or PARSER_LOGIC_REVISION changes
+    static uint32_t parserSetVersion();
+
+private:
+    struct MemoryEntry {
+        size_t inputSize;
+        ResultStore results;
+    };
+    using MemoryList = std::list<std::pair<std::string, MemoryEntry>>;
+
+    fs::path entryPath(const std::string& key) const;
+    bool loadMemory(const std::string& key, size_t inputSize, ResultStore& out) const;
+    void storeMemory(const std::string& key, size_t inputSize, const ResultStore& results) const;
+
+    fs::path directory;
+    bool useSha256;
+    size_t memoryEntries = 0;
+    mutable std::mutex memoryMutex;
+    mutable MemoryList memory;  // most recently used first
+    mutable std::unordered_map<std::string, MemoryList::iterator> memoryIndex;
+};
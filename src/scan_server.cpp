@@ -0,0 +1,482 @@
+#include "scan_server.hpp"
+#include "hexdig.hpp"
+#include "scan_cache.hpp"
+#include "parser_profile.hpp"
+#include "logger.hpp"
+#include "printer.hpp"
+#include "thread_pool.hpp"
+#include "cJSON.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t MAX_REQUEST = 4096;
+constexpr auto REQUEST_TIMEOUT = std::chrono::seconds(5);  // for the whole request line
+constexpr size_t MAX_READING = 64;  // connections whose request is still being read
+constexpr int ACCEPT_POLL_MS = 500;
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void onStopSignal(int) {
+    stopRequested = 1;
+}
+
+bool sendAll(int conn, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(conn, data.data() + sent, data.size() - sent, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Builds a one-line JSON object from string and number fields
+class JsonLine {
+public:
+    JsonLine() : obj(cJSON_CreateObject()) {}
+    ~JsonLine() { cJSON_Delete(obj); }
+    JsonLine& add(const char* key, const std::string& value) {
+        cJSON_AddStringToObject(obj, key, value.c_str());
+        return *this;
+    }
+    JsonLine& add(const char* key, double value) {
+        cJSON_AddNumberToObject(obj, key, value);
+        return *this;
+    }
+    JsonLine& flag(const char* key) {
+        cJSON_AddBoolToObject(obj, key, 1);
+        return *this;
+    }
+    std::string str() const {
+        char* s = cJSON_PrintUnformatted(obj);
+        std::string line(s);
+        std::free(s);
+        return line + "\n";
+    }
+
+private:
+    cJSON* obj;
+};
+
+void sendError(int conn, const std::string& message) {
+    sendAll(conn, JsonLine().add("error", message).str());
+}
+
+struct Job {
+    int conn = -1;
+    int fd = -1;        // input, owned by the job
+    std::string name;   // reported as the source
+    uint64_t size = 0;  // known size of regular files, 0 otherwise
+};
+
+// A connection whose request line is still arriving
+struct Request {
+    int conn = -1;
+    int fd = -1;  // descriptor passed with the request, if any
+    std::string line;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+enum class ReadState { More, Done, Failed };
+
+// Reads what has arrived of the request line and the descriptor passed
+// with it, without waiting for more
+ReadState readRequest(Request& req) {
+    char buf[MAX_REQUEST];
+    while (req.line.size() < MAX_REQUEST) {
+        alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        struct iovec iov{buf, MAX_REQUEST - req.line.size()};
+        struct msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        ssize_t n = ::recvmsg(req.conn, &msg, MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return ReadState::More;
+        if (n <= 0)
+            return ReadState::Failed;
+        for (struct cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) {
+                int passed;
+                std::memcpy(&passed, CMSG_DATA(c), sizeof(int));
+                if (req.fd >= 0)
+                    ::close(req.fd);
+                req.fd = passed;
+            }
+        }
+        req.line.append(buf, static_cast<size_t>(n));
+        size_t nl = req.line.find('\n');
+        if (nl != std::string::npos) {
+            req.line.resize(nl);
+            return ReadState::Done;
+        }
+    }
+    return ReadState::Failed;
+}
+
+// Parses and checks a complete request; on refusal the error has been sent
+bool admit(Request& request, const ServerOptions& options, Job& job) {
+    int conn = request.conn;
+    const std::string& line = request.line;
+    job.fd = request.fd;
+    request.fd = -1;  // owned by the job now
+
+    cJSON* req = cJSON_ParseWithLength(line.data(), line.size());
+    const cJSON* path = req ? cJSON_GetObjectItemCaseSensitive(req, "path") : nullptr;
+    const cJSON* name = req ? cJSON_GetObjectItemCaseSensitive(req, "name") : nullptr;
+    if (!req) {
+        sendError(conn, "request is not JSON");
+        return false;
+    }
+    std::string pathValue = cJSON_IsString(path) ? path->valuestring : "";
+    job.name = cJSON_IsString(name) ? name->valuestring : pathValue;
+    cJSON_Delete(req);
+
+    if (job.fd < 0) {
+        if (pathValue.empty()) {
+            sendError(conn, "request needs a path or a descriptor");
+            return false;
+        }
+        job.fd = ::open(pathValue.c_str(), O_RDONLY);
+        if (job.fd < 0) {
+            sendError(conn, "cannot open " + pathValue + ": " + std::strerror(errno));
+            return false;
+        }
+    }
+    if (job.name.empty())
+        job.name = "<fd>";
+
+    struct stat st{};
+    if (fstat(job.fd, &st) != 0 || S_ISDIR(st.st_mode)) {
+        sendError(conn, "not a file: " + job.name);
+        return false;
+    }
+    if (S_ISREG(st.st_mode)) {
+        job.size = static_cast<uint64_t>(st.st_size);
+        if (job.size > options.maxJobSize) {
+            sendError(conn, "input of " + std::to_string(job.size) + " bytes exceeds the job limit of " +
+                            std::to_string(options.maxJobSize));
+            return false;
+        }
+    }
+    return true;
+}
+
+// Waits until fd can be read or the deadline passes
+bool waitReadable(int fd, std::chrono::steady_clock::time_point deadline) {
+    while (true) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0)
+            return false;
+        struct pollfd p{fd, POLLIN, 0};
+        int ready = ::poll(&p, 1, static_cast<int>(std::min<long long>(left, INT32_MAX)));
+        if (ready > 0)
+            return true;
+        if (ready < 0 && errno != EINTR)
+            return true;  // let read() report the error
+    }
+}
+
+enum class InputState { Read, TooLarge, TimedOut };
+
+// Reads the whole input, pipes included, up to the job limit. A pipe or
+// socket that the client keeps open without sending gives up at the
+// deadline instead of holding the worker.
+InputState readInput(Job& job, uint64_t limit, std::chrono::steady_clock::time_point deadline,
+                     std::vector<uint8_t>& blob) {
+    blob.resize(job.size ? job.size : 1u << 16);
+    size_t have = 0;
+    while (true) {
+        if (!waitReadable(job.fd, deadline))
+            return InputState::TimedOut;
+        if (have == blob.size() && have == job.size) {
+            // The expected end of a regular file, only grow if it did too
+            uint8_t extra;
+            ssize_t n = ::read(job.fd, &extra, 1);
+            if (n <= 0)
+                break;
+            blob.push_back(extra);
+            ++have;
+        }
+        if (have == blob.size()) {
+            if (blob.size() > limit)
+                return InputState::TooLarge;
+            blob.resize(std::min<uint64_t>(blob.size() * 2, limit + 1));
+        }
+        ssize_t n = ::read(job.fd, blob.data() + have, blob.size() - have);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        have += static_cast<size_t>(n);
+    }
+    blob.resize(have);
+    return have <= limit ? InputState::Read : InputState::TooLarge;
+}
+
+void runJob(Job job, const ServerOptions& options, ScanCache* cache, ParserProfile* profile) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> blob;
+    InputState input = readInput(job, options.maxJobSize, start + std::chrono::seconds(options.inputTimeout), blob);
+    if (input == InputState::TooLarge) {
+        sendError(job.conn, "input exceeds the job limit of " + std::to_string(options.maxJobSize) + " bytes");
+    } else if (input == InputState::TimedOut) {
+        sendError(job.conn, "input not read within " + std::to_string(options.inputTimeout) + " seconds");
+    } else {
+        hexdig::ScanOptions scanOptions;
+        scanOptions.verbose = options.verbose;
+        scanOptions.skipHighEntropy = options.skipHighEntropy;
+        scanOptions.blockAlignment = options.blockAlignment;
+        scanOptions.budgets = options.budgets;
+        scanOptions.cache = cache;
+        scanOptions.profile = profile;
+        bool connected = true;
+        auto results = hexdig::scan(blob, job.name, scanOptions, [&](const ResultView& result) {
+            if (connected)
+                connected = sendAll(job.conn, jsonLine(result) + "\n");
+        });
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        sendAll(job.conn, JsonLine().flag("done").add("file", job.name)
+                              .add("size", static_cast<double>(blob.size()))
+                              .add("results", static_cast<double>(results.rootCount()))
+                              .add("elapsed_us", static_cast<double>(us)).str());
+    }
+    ::close(job.fd);
+    ::close(job.conn);
+}
+
+bool socketAddress(const std::string& path, struct sockaddr_un& addr) {
+    addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        Logger::error("Socket path too long: " + path);
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+} // namespace
+
+int runScanServer(const ServerOptions& options) {
+    struct sockaddr_un addr;
+    if (!socketAddress(options.socketPath, addr))
+        return 1;
+    int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        Logger::error(std::string("Cannot create socket: ") + std::strerror(errno));
+        return 1;
+    }
+    ::unlink(options.socketPath.c_str());
+    // Only the owner may submit jobs
+    mode_t oldMask = ::umask(0077);
+    int bound = ::bind(listenFd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    ::umask(oldMask);
+    if (bound != 0 || ::listen(listenFd, 128) != 0) {
+        Logger::error("Cannot listen on " + options.socketPath + ": " + std::strerror(errno));
+        ::close(listenFd);
+        return 1;
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+
+    ScanCache cache(options.cacheDir, options.cacheSha256);
+    cache.keepInMemory(options.cacheEntries);
+    // Probe order learnt from the jobs, kept across restarts
+    ParserProfile profile;
+    if (!options.statsFile.empty())
+        profile.load(options.statsFile);
+    std::atomic<size_t> pending{0};
+    {
+        ThreadPool pool(options.jobs);
+        Logger::info("Serving on " + options.socketPath + " with " + std::to_string(pool.size()) + " workers");
+
+        // Request lines are read by polling all connections together, each
+        // with a deadline for its whole request, so a client that sends
+        // slowly holds up nobody but itself
+        std::vector<Request> reading;
+        auto finish = [&](Request& req) {
+            // The request is read even when busy, a client that is still
+            // sending would not get the reply otherwise
+            Job job;
+            job.conn = req.conn;
+            bool admitted = admit(req, options, job);
+            if (admitted && pending.load() >= options.maxQueue) {
+                sendError(req.conn, "busy, " + std::to_string(pending.load()) + " jobs pending");
+                admitted = false;
+            }
+            if (!admitted) {
+                if (job.fd >= 0)
+                    ::close(job.fd);
+                ::close(req.conn);
+                return;
+            }
+            Logger::debug("Job " + job.name);
+            ++pending;
+            pool.submit([job, &options, &cache, &profile, &pending] {
+                runJob(job, options, &cache, options.statsFile.empty() ? nullptr : &profile);
+                --pending;
+            });
+        };
+        auto drop = [](Request& req, const std::string& message) {
+            if (req.fd >= 0)
+                ::close(req.fd);
+            sendError(req.conn, message);
+            ::close(req.conn);
+        };
+
+        std::vector<struct pollfd> polled;
+        while (!stopRequested) {
+            // New connections wait in the backlog while too many are read
+            polled.assign(1, {reading.size() < MAX_READING ? listenFd : -1, POLLIN, 0});
+            for (const Request& req : reading)
+                polled.push_back({req.conn, POLLIN, 0});
+            auto now = std::chrono::steady_clock::now();
+            int timeout = ACCEPT_POLL_MS;
+            for (const Request& req : reading) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(req.deadline - now).count();
+                timeout = static_cast<int>(std::max<long long>(0, std::min<long long>(timeout, left + 1)));
+            }
+            if (::poll(polled.data(), polled.size(), timeout) < 0 && errno != EINTR)
+                break;
+
+            now = std::chrono::steady_clock::now();
+            std::vector<Request> waiting;
+            for (size_t i = 0; i < reading.size(); ++i) {
+                Request& req = reading[i];
+                ReadState state = polled[i + 1].revents ? readRequest(req) : ReadState::More;
+                if (state == ReadState::Done)
+                    finish(req);
+                else if (state == ReadState::Failed)
+                    drop(req, "incomplete request");
+                else if (now >= req.deadline)
+                    drop(req, "request timed out");
+                else
+                    waiting.push_back(std::move(req));
+            }
+            reading = std::move(waiting);
+
+            if (polled[0].revents & POLLIN) {
+                int conn = ::accept(listenFd, nullptr, nullptr);
+                if (conn >= 0) {
+                    Request req;
+                    req.conn = conn;
+                    req.deadline = now + REQUEST_TIMEOUT;
+                    reading.push_back(std::move(req));
+                }
+            }
+        }
+        for (Request& req : reading)
+            drop(req, "server stopping");
+        Logger::info("Stopping, finishing " + std::to_string(pending.load()) + " jobs");
+    }
+    if (!options.statsFile.empty())
+        profile.save(options.statsFile);
+    ::close(listenFd);
+    ::unlink(options.socketPath.c_str());
+    return 0;
+}
+
+int submitScanJobs(const std::string& socketPath, const std::vector<std::string>& inputs) {
+    struct sockaddr_un addr;
+    if (!socketAddress(socketPath, addr))
+        return 1;
+    std::signal(SIGPIPE, SIG_IGN);
+    int status = 0;
+    for (const auto& input : inputs) {
+        int fd = input == "-" ? STDIN_FILENO : ::open(input.c_str(), O_RDONLY);
+        if (fd < 0) {
+            Logger::error("Error: Cannot open file " + input);
+            status = 1;
+            continue;
+        }
+        int conn = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (conn < 0 || ::connect(conn, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+            Logger::error("Cannot connect to " + socketPath + ": " + std::strerror(errno));
+            if (conn >= 0)
+                ::close(conn);
+            if (fd != STDIN_FILENO)
+                ::close(fd);
+            return 1;
+        }
+
+        std::string request = JsonLine().add("name", input == "-" ? std::string("<stdin>") : input).str();
+        alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+        struct iovec iov{const_cast<char*>(request.data()), request.size()};
+        struct msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        struct cmsghdr* c = CMSG_FIRSTHDR(&msg);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type = SCM_RIGHTS;
+        c->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(c), &fd, sizeof(int));
+        bool sent = ::sendmsg(conn, &msg, 0) == static_cast<ssize_t>(request.size());
+        if (fd != STDIN_FILENO)
+            ::close(fd);
+
+        // Relay the replies; the last line tells whether the job succeeded
+        std::string last;
+        char buf[1 << 16];
+        ssize_t n;
+        while ((n = ::read(conn, buf, sizeof(buf))) != 0) {
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            std::fwrite(buf, 1, static_cast<size_t>(n), stdout);
+            last.append(buf, static_cast<size_t>(n));
+            if (last.size() > MAX_REQUEST)
+                last.erase(0, last.size() - MAX_REQUEST);
+        }
+        std::fflush(stdout);
+        ::close(conn);
+        if (!sent || last.find("\"done\"") == std::string::npos)
+            status = 1;
+    }
+    return status;
+}
+
+#else
+
+int runScanServer(const ServerOptions&) {
+    Logger::error("--serve needs Unix domain sockets, not available on this platform");
+    return 1;
+}
+
+int submitScanJobs(const std::string&, const std::vector<std::string>&) {
+    Logger::error("--submit needs Unix domain sockets, not available on this platform");
+    return 1;
+}
+
+#endif
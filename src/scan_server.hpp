@@ -0,0 +1,44 @@
+#pragma once
+#include "budget.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr size_t DEFAULT_SERVER_QUEUE = 64;
+constexpr uint64_t DEFAULT_SERVER_MAX_JOB = 1ull << 30;
+constexpr unsigned DEFAULT_SERVER_INPUT_TIMEOUT_S = 60;
+constexpr size_t DEFAULT_SERVER_CACHE_ENTRIES = 4096;
+
+// Settings of a scan daemon (--serve). Jobs are scan-only, nothing is
+// extracted on the server side.
+struct ServerOptions {
+    std::string socketPath;
+    size_t jobs = 0;                              // worker threads, 0 = one per CPU
+    size_t maxQueue = DEFAULT_SERVER_QUEUE;       // jobs queued or running before new ones are refused
+    uint64_t maxJobSize = DEFAULT_SERVER_MAX_JOB; // larger inputs are refused
+    unsigned inputTimeout = DEFAULT_SERVER_INPUT_TIMEOUT_S;  // seconds to read a job's whole input
+    size_t cacheEntries = DEFAULT_SERVER_CACHE_ENTRIES;  // results kept in memory
+    std::string cacheDir;                         // optional on-disk cache below the memory one
+    bool cacheSha256 = false;
+    bool verbose = false;
+    bool skipHighEntropy = false;
+    size_t blockAlignment = 0;
+    BudgetConfig budgets;  // per job, see --budget
+    std::string statsFile; // parser stats loaded at start and saved at exit, see --parser-stats
+};
+
+// Serves scan jobs on a Unix domain socket until SIGINT/SIGTERM.
+//
+// A client connects and sends one request line of JSON:
+//   {"path": "/abs/file"}                 scan a file the server can open
+//   {"name": "label"} + SCM_RIGHTS fd     scan the passed descriptor
+// within a few seconds of connecting, and receives NDJSON: one line per
+// top-level result as soon as it is found, then {"done": true, ...} or a
+// single {"error": "..."} line. The input, a passed pipe included, has to
+// be read to its end within ServerOptions::inputTimeout.
+int runScanServer(const ServerOptions& options);
+
+// Client side (--submit): sends each input to the server as a descriptor
+// and copies the NDJSON replies to stdout. Non-zero if a job failed.
+int submitScanJobs(const std::string& socketPath, const std::vector<std::string>& inputs);
@@ -7,7 +7,89 @@
 #include "logger.hpp"
 #include "printer.hpp"
 #include "helpers.hpp"
+#include "hash.hpp"
 #include <chrono>
+#include <array>
+#include <optional>
+#include <sstream>
+#include <cmath>
+#include <utility>
+#include "byte_scan.hpp"
+#include "entropy.hpp"
+#include "thread_pool.hpp"
+#include "stream_input.hpp"
+#include "file_reader.hpp"
+
+// Uniform runs shorter than this are scanned byte by byte
+static constexpr size_t MIN_PADDING_RUN = 4096;
+// Bytes at the end of a run that are still scanned, longer than the header
+// lookahead of any parser, so signatures that start inside the padding and
+// end after it are still found
+static constexpr size_t PADDING_GUARD = 1024;
+// Holes of sparse files shorter than this are read as zeros, longer ones are
+// jumped over; SPARSE_GUARD zeros of a skipped hole stay in the window as
+// lookahead for candidates just before it
+static constexpr uint64_t MIN_SPARSE_HOLE = 1u << 20;
+static constexpr size_t SPARSE_GUARD = 4096;
+// Block size of the entropy profile used by skipHighEntropy
+static constexpr size_t ENTROPY_SKIP_BLOCK = 1024;
+// Scan loop iterations between two checks of the scan deadline
+static constexpr size_t BUDGET_CHECK_INTERVAL = 256;
+// With a profile, one probe in this many of each parser is timed
+static constexpr uint64_t PROFILE_SAMPLE = 16;
+
+// A byte value is only treated as padding if no parser matches anywhere in a
+// buffer made entirely of that value, i.e. no signature is made of it.
+static const bool* paddingByteTable(const std::vector<std::unique_ptr<BaseParser>>& parsers) {
+    static const std::array<bool, 256> table = [&parsers] {
+        std::array<bool, 256> t{};
+        for (uint8_t value : {uint8_t(0x00), uint8_t(0xFF)}) {
+            std::vector<uint8_t> probe(2 * PADDING_GUARD, value);
+            bool skippable = true;
+            for (const auto& parser : parsers) {
+                for (size_t off : {size_t(0), size_t(1), PADDING_GUARD}) {
+                    if (parser->match(probe, off)) {
+                        Logger::debug("Padding skip disabled for 0x" + to_hex(value) + " by " + parser->name());
+                        skippable = false;
+                    }
+                }
+            }
+            t[value] = skippable;
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+// A result cut short by a budget is reported as such rather than dropped
+static void markBudgetExceeded(ScanResult& result, const std::string& what) {
+    result.budgetExceeded = true;
+    if (!result.info.empty())
+        result.info += ", ";
+    result.info += what;
+}
+
+static bool anyBudgetExceeded(const ResultStore& results, ResultId first) {
+    for (ResultId id = first; id < results.size(); ++id)
+        if (results[id].budgetExceeded())
+            return true;
+    return false;
+}
+
+// Extractors without a loop of their own that charges the budget are
+// accounted for by what they wrote
+static void settleExtraction(Budget& budget, const fs::path& dir, ScanResult& result) {
+    uint64_t written = 0;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file(ec))
+            written += it->file_size(ec);
+    }
+    if (written > budget.used())
+        budget.charge(written - budget.used());
+    if (budget.exceeded())
+        markBudgetExceeded(result, "extraction budget exceeded (" + budget.reason() + ")");
+}
 
 Scanner::Scanner(bool enableExtraction, int recursionDepth, int currentDepth,fs::path extractionPath,bool verbose)
     : enableExtraction(enableExtraction),
@@ -15,56 +97,360 @@ Scanner::Scanner(bool enableExtraction, int recursionDepth, int currentDepth,fs:
       currentDepth(currentDepth),verbose(verbose){
     parsers = ParserRegistry::instance().createAll();
     extractors = ExtractorRegistry::instance().createAll();
+    paddingBytes = paddingByteTable(parsers);
+    for (const auto& parser : parsers)
+        structured.push_back(parser->needsStructuredData());
+    // Registration order is kept within each bucket, it decides which parser
+    // wins when several accept the same offset
+    for (size_t i = 0; i < parsers.size(); ++i) {
+        std::array<bool, 256> anchors{};
+        std::vector<uint8_t> bytes = parsers[i]->anchorBytes();
+        if (bytes.empty())
+            anchors.fill(true);
+        for (uint8_t b : bytes)
+            anchors[b] = true;
+        for (size_t value = 0; value < anchors.size(); ++value) {
+            if (!anchors[value])
+                continue;
+            dispatch[value].push_back(i);
+            if (!parsers[i]->blockAligned())
+                unalignedDispatch[value].push_back(i);
+        }
+    }
     this->extractionPath = extractionPath;
 
 }
 
 
-std::vector<ScanResult> Scanner::scan(fs::path filePath) {
+void Scanner::addSink(ResultSink* sink) {
+    sinks.push_back(sink);
+}
+
+ResultStore& Scanner::store() {
+    return parent ? parent->store() : results;
+}
+
+// Adds a result of the blob being scanned, or completes the one reserved as
+// `id` before the results of its extracted artifacts were added
+ResultId Scanner::pushResult(const ScanResult& result, ResultId id) {
+    ResultStore& out = store();
+    if (id == NO_RESULT)
+        id = out.add(result, parentResult, currentSourceId);
+    else
+        out.update(id, result);
+    for (auto* sink : sinks)
+        sink->onResult(out[id]);
+    return id;
+}
+
+ResultStore Scanner::scan(fs::path filePath) {
+    startScan();
+    for (auto* sink : sinks)
+        sink->beginScan(filePath.string());
+    scanFile(filePath);
+    for (auto* sink : sinks)
+        sink->endScan();
+    finishScan();
+    return std::exchange(results, ResultStore());
+}
+
+ResultStore Scanner::scanStream(const fs::path& input) {
+    StreamInput in;
+    if (!in.open(input)) {
+        Logger::error("Error: Cannot open file " + input.string());
+        return ResultStore();
+    }
+    return scanStream(in, input.string());
+}
+
+ResultStore Scanner::scanStream(InputSource& in, const std::string& name) {
+    startScan();
+    for (auto* sink : sinks)
+        sink->beginScan(name);
+    currentSource = name == "-" ? std::string("<stdin>") : name;
+    currentSourceId = store().intern(currentSource);
+    streamFile(in);
+    for (auto* sink : sinks)
+        sink->endScan();
+    finishScan();
+    return std::exchange(results, ResultStore());
+}
+
+// Appends input to buf until it holds `size` bytes, the input ends or, with
+// stopAtHole, a hole long enough to be skipped starts. Short holes are
+// filled with zeros without reading them.
+static void fillWindow(InputSource& in, std::vector<uint8_t>& buf, size_t size,
+                       bool stopAtHole, bool& eof, uint64_t& holeAhead) {
+    holeAhead = 0;
+    while (buf.size() < size) {
+        size_t room = size - buf.size();
+        uint64_t hole = in.holeLength();
+        if (hole >= MIN_SPARSE_HOLE && stopAtHole) {
+            holeAhead = hole;
+            return;
+        }
+        if (hole > 0) {
+            size_t n = static_cast<size_t>(std::min<uint64_t>(hole, room));
+            buf.resize(buf.size() + n, 0);
+            in.skip(n);
+            continue;
+        }
+        size_t want = static_cast<size_t>(std::min<uint64_t>(in.dataLength(), room));
+        if (want == 0) {
+            eof = true;
+            return;
+        }
+        size_t have = buf.size();
+        buf.resize(have + want);
+        size_t n = in.read(buf.data() + have, want);
+        buf.resize(have + n);
+        if (n < want) {
+            eof = true;
+            return;
+        }
+    }
+}
+
+void Scanner::streamFile(InputSource& in) {
+    if (enableExtraction)
+        Logger::error("Extraction is not available in streaming mode, scanning only");
+    streamInput = &in;
+
+    size_t windowSize = std::max(streamWindow, 2 * STREAM_LOOKAHEAD);
+    size_t maxWindow = std::max(streamMaxWindow, windowSize);
+    size_t capacity = windowSize;
+    std::vector<uint8_t> blob;
+    blob.reserve(maxWindow + SPARSE_GUARD);  // grown windows never reallocate
+    uint64_t base = 0;
+    bool eof = false;
+    bool growing = false;
+    bool saved = enableExtraction;
+    enableExtraction = false;
+    while (true) {
+        uint64_t hole = 0;
+        if (!eof)
+            fillWindow(in, blob, capacity, !growing, eof, hole);
+        if (blob.empty() && hole == 0)
+            break;
+
+        ScanWindow window;
+        window.base = base;
+        window.complete = eof;
+        window.growable = !eof && capacity < maxWindow;
+        if (eof) {
+            window.end = blob.size();
+        } else if (hole) {
+            // The data before the hole is scanned completely, with a few
+            // zeros of the hole as lookahead
+            window.end = blob.size();
+            blob.resize(blob.size() + SPARSE_GUARD, 0);
+        } else {
+            window.end = blob.size() - STREAM_LOOKAHEAD;
+        }
+        if (window.end > 0)
+            scanBlob(blob, window);
+        if (scanBudget && scanBudget->expired())
+            break;
+
+        growing = window.needMore;
+        if (window.needMore) {
+            Logger::debug("Growing stream window at 0x" + to_hex(base + window.stop));
+            capacity = std::min(capacity * 2, maxWindow);
+        } else {
+            capacity = windowSize;
+        }
+
+        if (hole && !window.needMore) {
+            // Continue after the hole, or after a result that spans it
+            uint64_t holeStart = base + window.end;
+            uint64_t next = std::max(base + window.stop, holeStart + hole);
+            if (verbose) {
+                ScanResult sparse;
+                sparse.offset = holeStart;
+                sparse.length = hole;
+                sparse.type = "SPARSE";
+                sparse.info = "Hole in a sparse file, not read";
+                sparse.isValid = true;
+                pushResult(sparse);
+            }
+            Logger::debug("Skipping sparse hole at 0x" + to_hex(holeStart) + " length " + std::to_string(hole));
+            in.skip(next - in.position());
+            base = next;
+            blob.clear();
+            eof = in.size() > 0 && next >= in.size();
+            if (eof)
+                break;
+            continue;
+        }
+        if (hole)
+            blob.resize(window.end);  // drop the guard zeros, the hole is read when growing
+
+        if (window.stop >= blob.size()) {
+            // A result spans past the window, continue after it
+            if (!eof)
+                in.skip(base + window.stop - in.position());
+            base += window.stop;
+            blob.clear();
+            if (eof)
+                break;
+        } else {
+            blob.erase(blob.begin(), blob.begin() + window.stop);
+            base += window.stop;
+        }
+    }
+    enableExtraction = saved;
+    streamInput = nullptr;
+}
+
+void Scanner::scanFile(const fs::path& filePath) {
     Logger::debug("Scanner::scan " + filePath.string()+"("+std::to_string(currentDepth)+")");
     if(!std::filesystem::is_regular_file(filePath))
     {
         Logger::error("Error, not a regular file");
-        return results;
+        return;
     }
-    std::ifstream file(filePath, std::ios::binary);
-    if (!file) {
+    MappedFile file;
+    if (!file.open(filePath.string())) {
         Logger::error("Error: Cannot open file " + filePath.string());
-        return results;
+        return;
     }
+    scanLoaded(file.view(), filePath);
+}
+
+ResultStore Scanner::scanBuffer(const ByteView& blob, const std::string& name) {
+    startScan();
+    for (auto* sink : sinks)
+        sink->beginScan(name);
+    scanLoaded(blob, fs::path(name));
+    for (auto* sink : sinks)
+        sink->endScan();
+    finishScan();
+    return std::exchange(results, ResultStore());
+}
 
-    std::vector<uint8_t> blob((std::istreambuf_iterator<char>(file)),
-                               std::istreambuf_iterator<char>());
+void Scanner::scanLoaded(const ByteView& blob, const fs::path& filePath) {
+    contentHash = xxhash64(blob.data(), blob.size());
+    contentSize = blob.size();
+    currentSource = filePath.string();
+    currentSourceId = store().intern(currentSource);
+    if (checkDuplicate(filePath))
+        return;
+
+    ResultStore& out = store();
+    ResultId first = static_cast<ResultId>(out.size());
+    std::string cacheKey;
+    // A cache hit extracts nothing, so results that point at extracted
+    // files are never taken from the cache
+    bool cached = cache && !enableExtraction;
+    if (cached) {
+        cacheKey = cache->key(blob, contentHash, cacheOptions());
+        ResultStore cached;
+        if (cache->load(cacheKey, blob, cached)) {
+            out.append(cached, parentResult, currentSourceId);
+            for (ResultId id = first; id < out.size(); ++id) {
+                if (out[id].parent() == parentResult)
+                    for (auto* sink : sinks)
+                        sink->onResult(out[id]);
+            }
+            recordResults(out.size() > first);
+            return;
+        }
+    }
     
-    size_t offset = 0;
     //Logger::debug("BLOBNAME: "+blobName);
     //Logger::debug("EXTRPATH: "+extractionPath.string());
     extractionPath = extractionPath / fs::path(filePath.filename().string() + ".extracted");
+    ScanWindow window;
+    window.end = blob.size();
+    scanBlob(blob, window);
+    recordResults(out.size() > first);
+
+    // Results cut short by a budget are not the results of this blob
+    if (cached && !anyBudgetExceeded(out, first))
+        cache->store(cacheKey, blob, contentHash, filePath.string(), out.slice(first));
+}
+
+// Scans blob[0, window.end). Reported offsets are shifted by window.base,
+// the input position of blob[0], so the same loop serves whole files and
+// the windows of a streaming scan.
+void Scanner::scanBlob(const ByteView& blob, ScanWindow& window) {
+    size_t offset = 0;
+    size_t front = 0;  // offsets below this have been probed already
+    size_t paddingEnd = 0;  // end of the last padding run measured, offsets below it are not measured again
+    EntropyProfile entropy;
+    if (skipHighEntropy)
+        entropy = computeEntropy(blob.data(), blob.size(), ENTROPY_SKIP_BLOCK, &ThreadPool::shared());
+    signatures.build(blob);
+    for (const auto& parser : parsers)
+        parser->prepare(blob, signatures);
+    nextCandidate.assign(parsers.size(), 0);
     int total = 0;
-    while (offset < blob.size()) {
-        if (visitedOffsets.count(offset)) {
-            ++offset;
+    const bool timed = Logger::level >= LogLevel::DEBUG;  // per-parse timings are debug output
+    size_t ticks = 0;  // iterations until the scan deadline is checked again
+    while (offset < window.end) {
+        if (scanBudget && ticks-- == 0) {
+            ticks = BUDGET_CHECK_INTERVAL;
+            if (scanBudget->expired()) {
+                stopOnBudget(offset, window);
+                offset = window.end;
+                break;
+            }
+        }
+        if (offset >= paddingEnd && paddingBytes[blob[offset]]) {
+            size_t next = skipPadding(blob, offset, window, paddingEnd);
+            if (next != offset) {
+                offset = next;
+                continue;
+            }
+        }
+        if (offset < front) {
+            offset = front;
             continue;
         }
-        visitedOffsets.insert(offset);
+        front = offset + 1;
 
         bool matched = false;
-        for (const auto& parser : parsers) {
-            if (parser->match(blob, offset)) {
-                Logger::debug(to_hex(offset) + " " + parser->name());
-                auto start =  std::chrono::high_resolution_clock::now();
-                
-                ScanResult result = parser->parse(blob, offset);
+        bool highEntropy = skipHighEntropy && entropy.isHigh(offset);
+        // Alignment is a property of the input position, not of the window
+        bool aligned = blockAlignment <= 1 || (window.base + offset) % blockAlignment == 0;
+        const auto& candidates = aligned ? dispatch[blob[offset]] : unalignedDispatch[blob[offset]];
+        for (size_t index : candidates) {
+            if (offset < nextCandidate[index])
+                continue;
+            if (highEntropy && structured[index])
+                continue;
+            BaseParser* parser = parsers[index].get();
+            std::chrono::high_resolution_clock::time_point start;
+            if (timed)
+                start = std::chrono::high_resolution_clock::now();
+            std::optional<ScanResult> probed = probeParser(index, blob, offset);
+            if (probed && probed->nextCandidate > offset)
+                nextCandidate[index] = probed->nextCandidate;
+            // A candidate that could not be decided inside a streaming window
+            // is retried from its offset with a larger window
+            if (probed && window.growable && !probed->budgetExceeded &&
+                (probed->needsMoreData ||
+                 (probed->isValid && probed->offset + probed->length >= blob.size()))) {
+                window.needMore = true;
+                window.stop = std::min(offset, probed->offset);
+                return;
+            }
+            if (probed) {
+                ScanResult& result = *probed;
+                Logger::debug(to_hex(window.base + offset) + " " + parser->name());
                 offset = result.offset;
-                result.source = filePath.string();
-                auto end =  std::chrono::high_resolution_clock::now();
-                int diff = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-                total += diff;
-                Logger::debug(std::to_string(diff));
+                result.offset += window.base;
+                if (timed) {
+                    auto end =  std::chrono::high_resolution_clock::now();
+                    int diff = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+                    total += diff;
+                    Logger::debug(std::to_string(diff));
+                }
 
                 result.extracted = false;
                 if(result.isValid)
                 {
+                    ResultId id = NO_RESULT;  // added before the results of its artifacts
 
                     if (enableExtraction && recursionDepth > 0) {
                         
@@ -72,32 +458,59 @@ std::vector<ScanResult> Scanner::scan(fs::path filePath) {
                             if(result.extractorType.compare(extractor->name()) == 0 )
                             {
                                 Logger::debug("Using "+extractor->name()+" extractor with path: "+extractionPath.string());
-                                Logger::debug(to_hex(offset) + " " + filePath.filename().string());
-                                if(extractor->name() == "RAW")
-                                {
-                                    if(result.length < blob.size())
-                                        extractor->extract(blob, offset, extractionPath,result.type);
+                                Logger::debug(to_hex(offset) + " " + currentSource);
+                                std::optional<Budget> budget;
+                                if (budgets) {
+                                    if (!scanBudget->ok()) {
+                                        markBudgetExceeded(result, "not extracted, budget exceeded (" + scanBudget->reason() + ")");
+                                        break;
+                                    }
+                                    budget.emplace(budgets->forExtractor(extractor->name()), scanBudget.get(), true);
                                 }
-                                else
                                 {
-                                    extractor->extract(blob, offset, extractionPath);
+                                    BudgetScope scope(budget ? &*budget : nullptr);
+                                    if(extractor->name() == "RAW")
+                                    {
+                                        if(result.length < blob.size())
+                                            extractor->extract(blob, offset, extractionPath,result.type);
+                                    }
+                                    else
+                                    {
+                                        extractor->extract(blob, offset, extractionPath);
+                                    }
                                 }
+                                auto artifacts = extractor->takeArtifacts();
+                                if (budget)
+                                    settleExtraction(*budget, extractionPath / to_hex(offset), result);
                                 
                                 result.extracted = true;
 
                                 if(recursionDepth > 0 && result.extractorType != "RAW")
                                 {
+                                    id = store().reserve(parentResult, currentSourceId);
                                     for (const auto& entry : std::filesystem::directory_iterator(extractionPath.string()+"/"+to_hex(offset))) {
                                             if (entry.is_regular_file()) {
 
                                                 Logger::debug("SCANREC: "+entry.path().string());
 
                                                 Scanner scanner(true, recursionDepth - 1,currentDepth+1,entry.path().parent_path());
-    
-                                                std::vector<ScanResult> tmpRes = scanner.scan(entry.path());
+                                                scanner.parent = this;
+                                                scanner.parentResult = id;
+                                                scanner.cache = cache;
+                                                scanner.registry = registry;
+                                                scanner.skipHighEntropy = skipHighEntropy;
+                                                scanner.blockAlignment = blockAlignment;
+                                                scanner.budgets = budgets;
+                                                scanner.scanBudget = scanBudget;
+                                                scanner.profile = profile;
 
-                                                result.children.insert(result.children.end(),std::make_move_iterator(tmpRes.begin()),std::make_move_iterator(tmpRes.end()));
-           
+                                                // Output still in memory is not read back from disk
+                                                auto kept = std::find_if(artifacts.begin(), artifacts.end(),
+                                                    [&](const auto& a) { return a.first == entry.path(); });
+                                                if (kept != artifacts.end())
+                                                    scanner.scanBuffer(kept->second, entry.path().string());
+                                                else
+                                                    scanner.scan(entry.path());
 
                                             }
                                         }
@@ -110,14 +523,18 @@ std::vector<ScanResult> Scanner::scan(fs::path filePath) {
     
                     }
 
-                    if(offset == 0 && result.length == blob.size() && result.extracted == false && !verbose)
+                    if(window.base == 0 && window.complete && offset == 0 && result.length == blob.size() && result.extracted == false && !result.budgetExceeded && !verbose)
                     {
                         Logger::debug("ignoring complete file");
                     }
                     else
                     {
-                        Logger::debug("Pushing detected file with offset "+std::to_string(offset)+" len: " + std::to_string(result.length)+ " blob: " + std::to_string(blob.size()));
-                        results.push_back(result);
+                        Logger::debug("Pushing detected file with offset "+std::to_string(result.offset)+" len: " + std::to_string(result.length)+ " blob: " + std::to_string(blob.size()));
+                        if (streamInput && streamInput->remapped()) {
+                            result.info.text(", physical offset 0x")
+                                .field("physical_offset", streamInput->physicalOffset(result.offset), InfoField::HEX);
+                        }
+                        pushResult(result, id);
                     }
                     
                     if(result.confident)
@@ -133,7 +550,218 @@ std::vector<ScanResult> Scanner::scan(fs::path filePath) {
             ++offset;
         }
     }
+    window.stop = offset;
     Logger::debug("total: " + std::to_string(total));
+}
+
+// The scan budget starts with the top-level scan, nested scanners share it.
+// Without limits nothing is set up and scans pay nothing for budgets.
+void Scanner::startScan() {
+    // Duplicates are looked for within one top-level scan only
+    if (!parent)
+        registry = std::make_shared<ContentRegistry>();
+    if (budgets && budgets->empty())
+        budgets = nullptr;
+    if (budgets) {
+        if (!scanBudget)
+            scanBudget = std::make_shared<Budget>(budgets->scan);
+        parserBudgets.clear();
+        for (const auto& parser : parsers)
+            parserBudgets.push_back(budgets->forParser(parser->name()));
+    }
+    if (profile) {
+        probeCounters.assign(parsers.size(), ParserCounters());
+        orderProbes();
+    }
+}
+
+void Scanner::finishScan() {
+    if (!profile)
+        return;
+    for (size_t i = 0; i < parsers.size(); ++i) {
+        if (probeCounters[i].probes)
+            profile->add(parsers[i]->name(), probeCounters[i]);
+    }
+    probeCounters.assign(parsers.size(), ParserCounters());
+}
+
+// Cost of reading the clock twice, taken off every timed probe
+static uint64_t clockOverhead() {
+    static const uint64_t overhead = [] {
+        uint64_t best = UINT64_MAX;
+        for (int i = 0; i < 64; ++i) {
+            auto a = std::chrono::steady_clock::now();
+            auto b = std::chrono::steady_clock::now();
+            best = std::min<uint64_t>(best, std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+        }
+        return best;
+    }();
+    return overhead;
+}
+
+// Orders the probes of every dispatch bucket by the profile: the parsers
+// with the lowest expected cost per accepted offset (time per probe over
+// hit rate) go first, so offsets where something is found are settled
+// after fewer probes. Only runs of Magic parsers are reordered, Ordered
+// parsers stay where registration put them (see ProbeTier), so the parser
+// that wins an offset is the same in any order.
+void Scanner::orderProbes() {
+    if (profile->empty())
+        return;
+    std::vector<double> score(parsers.size());
+    std::vector<char> magic(parsers.size());
+    for (size_t i = 0; i < parsers.size(); ++i) {
+        ParserCounters c = profile->get(parsers[i]->name());
+        double hitRate = (c.hits + 1.0) / (c.probes + 2.0);
+        score[i] = c.timed ? c.nanosPerProbe() / hitRate : HUGE_VAL;
+        magic[i] = parsers[i]->probeTier() == ProbeTier::Magic;
+    }
+    auto before = [&score](size_t a, size_t b) {
+        return score[a] != score[b] ? score[a] < score[b] : a < b;
+    };
+    size_t moved = 0;
+    for (auto* table : {&dispatch, &unalignedDispatch}) {
+        for (auto& bucket : *table) {
+            std::vector<size_t> old = bucket;
+            size_t run = 0;
+            for (size_t i = 0; i <= bucket.size(); ++i) {
+                if (i < bucket.size() && magic[bucket[i]])
+                    continue;
+                std::sort(bucket.begin() + run, bucket.begin() + i, before);
+                run = i + 1;
+            }
+            moved += bucket != old;
+        }
+    }
+    Logger::debug("Probe order changed in " + std::to_string(moved) + " dispatch buckets");
+}
+
+// Probes parsers[index], under its budget and counted in the profile if
+// either is set. A candidate the parser could not finish validating within
+// its budget is still reported, marked and not trusted for skipping.
+std::optional<ScanResult> Scanner::probeParser(size_t index, const ByteView& blob, size_t offset) {
+    if (!budgets && !profile)
+        return parsers[index]->probe(blob, offset);
+
+    std::optional<Budget> budget;
+    if (budgets)
+        budget.emplace(parserBudgets[index], scanBudget.get());
+    BudgetScope scope(budget ? &*budget : nullptr);
+    std::optional<ScanResult> probed;
+    if (profile && probeCounters[index].probes++ % PROFILE_SAMPLE == 0) {
+        auto start = std::chrono::steady_clock::now();
+        probed = parsers[index]->probe(blob, offset);
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        probeCounters[index].nanos += ns > clockOverhead() ? ns - clockOverhead() : 0;
+        ++probeCounters[index].timed;
+    } else {
+        probed = parsers[index]->probe(blob, offset);
+    }
+    if (profile && probed && probed->isValid)
+        ++probeCounters[index].hits;
+
+    if (probed && budget && budget->exceeded()) {
+        probed->isValid = true;
+        probed->confident = false;
+        probed->needsMoreData = false;
+        markBudgetExceeded(*probed, "budget exceeded (" + budget->reason() + ")");
+    }
+    return probed;
+}
+
+// The scan deadline has passed: report where the scan stopped
+void Scanner::stopOnBudget(size_t offset, const ScanWindow& window) {
+    ScanResult stop;
+    stop.offset = window.base + offset;
+    stop.length = window.complete ? window.end - offset : 0;
+    stop.type = "BUDGET";
+    stop.info = "Scan stopped, budget exceeded (" + scanBudget->reason() + "), the rest was not scanned";
+    stop.isValid = true;
+    stop.budgetExceeded = true;
+    pushResult(stop);
+}
+
+// Stops recursion when this blob is identical to one of the artifacts it was
+// extracted from (a cycle), or to an artifact already scanned elsewhere in
+// this scan (a duplicate). Either way a single reference result is reported
+// instead of scanning and extracting the same content again. Empty blobs
+// are not tracked, and a copy of content that gave no results is skipped
+// without a reference to nothing.
+bool Scanner::checkDuplicate(const fs::path& filePath) {
+    if (contentSize == 0)
+        return false;
+
+    ScanResult ref;
+    ref.offset = 0;
+    ref.length = contentSize;
+    ref.isValid = true;
+
+    for (Scanner* p = parent; p; p = p->parent) {
+        if (p->contentHash == contentHash && p->contentSize == contentSize) {
+            auto it = registry->seen.find(contentHash);
+            ref.type = "CYCLE";
+            ref.info = "Recursion stopped, content identical to enclosing artifact " +
+                       (it != registry->seen.end() ? it->second.source : std::string("?"));
+            Logger::debug(ref.info.str());
+            pushResult(ref);
+            return true;
+        }
+    }
+
+    auto it = registry->seen.find(contentHash);
+    if (it != registry->seen.end() && it->second.size == contentSize) {
+        if (!it->second.hasResults)
+            return true;
+        ref.type = "DUPLICATE";
+        ref.info = "Same content as " + it->second.source + ", see its results";
+        Logger::debug(ref.info.str());
+        pushResult(ref);
+        return true;
+    }
+
+    registry->seen.emplace(contentHash, ContentRegistry::Entry{contentSize, filePath.string()});
+    return false;
+}
+
+// Notes whether the blob registered by checkDuplicate() gave any results
+void Scanner::recordResults(bool hasResults) {
+    auto it = registry->seen.find(contentHash);
+    if (it != registry->seen.end() && it->second.size == contentSize)
+        it->second.hasResults = hasResults;
+}
+
+// Jumps over a long run of erased (0xFF) or zero padding. Only the tail of
+// the run is left to the parsers, also when the run reaches the end of a
+// streaming window; in verbose mode the skipped part is reported. `runEnd`
+// is set to the end of the run, short runs included, so the bytes inside
+// it are not measured again.
+size_t Scanner::skipPadding(const ByteView& blob, size_t offset, const ScanWindow& window, size_t& runEnd) {
+    uint8_t value = blob[offset];
+    size_t run = uniform_run_length(&blob[offset], blob.size() - offset, value);
+    runEnd = offset + run;
+    if (run < MIN_PADDING_RUN)
+        return offset;
+
+    size_t end = offset + run;
+    size_t next = end == blob.size() && window.complete ? end : end - PADDING_GUARD;
+    if (verbose) {
+        ScanResult pad;
+        pad.offset = window.base + offset;
+        pad.length = next - offset;
+        pad.type = "PADDING";
+        pad.info = "0x" + to_hex(value) + " padding";
+        pad.isValid = true;
+        pushResult(pad);
+    }
+    return next;
+}
 
-    return results;
+// Scan settings that change the result set, part of the cache key
+std::string Scanner::cacheOptions() const {
+    return "e" + std::to_string(enableExtraction) +
+           "r" + std::to_string(recursionDepth) +
+           "v" + std::to_string(verbose) +
+           "h" + std::to_string(skipHighEntropy) +
+           "a" + std::to_string(blockAlignment);
 }
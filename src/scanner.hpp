@@ -2,28 +2,118 @@
 #include "parsers/base_parser.hpp"
 #include "extractors/base_extractor.hpp"
 #include <vector>
+#include <array>
 #include <memory>
 #include <tuple>
+#include <optional>
 #include <unordered_set>
+#include <unordered_map>
 #include <filesystem>
-#include "scanresult.hpp"
+#include "result_store.hpp"
+#include "result_sink.hpp"
+#include "scan_cache.hpp"
+#include "signature_index.hpp"
+#include "stream_input.hpp"
+#include "budget.hpp"
+#include "parser_profile.hpp"
 namespace fs = std::filesystem;
+
+// Content hashes of everything scanned during one top-level scan, used to
+// stop on extraction cycles and to avoid rescanning duplicate artifacts.
+struct ContentRegistry {
+    struct Entry {
+        size_t size;
+        std::string source;
+        bool hasResults = false;  // set once the first copy has been scanned
+    };
+    std::unordered_map<uint64_t, Entry> seen;
+};
+
+// A part of the input held in memory: offsets below `end` are scanned,
+// the bytes after it are lookahead for candidates near the end.
+struct ScanWindow {
+    uint64_t base = 0;       // input offset of the first byte
+    size_t end = 0;
+    bool complete = true;    // the window reaches the end of the input
+    bool growable = false;   // a larger window can be read for undecided candidates
+    bool needMore = false;   // out: a candidate at `stop` needs a larger window
+    size_t stop = 0;         // out: where the scan stopped, may lie past `end`
+};
+
+constexpr size_t DEFAULT_STREAM_WINDOW = 64u << 20;
+constexpr size_t DEFAULT_STREAM_MAX_WINDOW = 512u << 20;
+// Bytes after a window's scan range that parsers can look at; more than any
+// fixed header lookahead
+constexpr size_t STREAM_LOOKAHEAD = 1u << 20;
+
 class Scanner {
 public:
     bool enableExtraction = false;
     int recursionDepth = 1;
     int currentDepth = 0;
     bool verbose = false;
+    bool skipHighEntropy = false;  // skip structure-dependent parsers in high-entropy regions
+    size_t blockAlignment = 0;     // if > 1, block-aligned parsers only run at multiples of it
 
-    std::vector<ScanResult> results;
-    std::unordered_set<size_t> visitedOffsets;
+    // Results of the scan running in this scanner; nested scanners add
+    // theirs to the store of the top-level one
+    ResultStore results;
     Scanner(bool enableExtraction, int recursionDepth, int currentDepth = 0,fs::path extractionPath = "extractions/",bool verbose = false);
-    std::vector<ScanResult> scan(fs::path filePath);
+    // The scan functions hand the results over when the scan is done
+    ResultStore scan(fs::path filePath);
+    // Scans data that is already in memory, reported as `name`
+    ResultStore scanBuffer(const ByteView& blob, const std::string& name);
+    // Scans a file, block device, pipe or "-" (stdin) through a bounded
+    // sliding window, so memory use does not depend on the input size.
+    // Results only, nothing is extracted.
+    ResultStore scanStream(const fs::path& input);
+    // Same over an already opened input, e.g. an input transformer; `name`
+    // is reported as the source
+    ResultStore scanStream(InputSource& in, const std::string& name);
+    size_t streamWindow = DEFAULT_STREAM_WINDOW;      // bytes scanned per window
+    size_t streamMaxWindow = DEFAULT_STREAM_MAX_WINDOW;  // read-ahead limit for one candidate
+    void addSink(ResultSink* sink);
 
     //void printResult(const ScanResult& result, int depth);
     Scanner * parent = nullptr;
     fs::path extractionPath;
+    ScanCache * cache = nullptr;   // shared with nested scanners, optional
+    std::shared_ptr<ContentRegistry> registry;  // shared with nested scanners
+    const BudgetConfig* budgets = nullptr;      // optional limits, see BudgetConfig
+    std::shared_ptr<Budget> scanBudget;         // of the top-level scan, shared with nested scanners
+    ParserProfile* profile = nullptr;           // probe counters, shared with nested scanners; orders the probes
+    uint64_t contentHash = 0;
+    size_t contentSize = 0;
 private:
+    void scanFile(const fs::path& filePath);
+    void scanLoaded(const ByteView& blob, const fs::path& filePath);
+    void streamFile(InputSource& in);
+    void scanBlob(const ByteView& blob, ScanWindow& window);
+    ResultStore& store();
+    ResultId pushResult(const ScanResult& result, ResultId id = NO_RESULT);
+    std::string cacheOptions() const;
+    bool checkDuplicate(const fs::path& filePath);
+    void recordResults(bool hasResults);
+    size_t skipPadding(const ByteView& blob, size_t offset, const ScanWindow& window, size_t& runEnd);
+    void startScan();
+    void finishScan();
+    void orderProbes();
+    void stopOnBudget(size_t offset, const ScanWindow& window);
+    std::optional<ScanResult> probeParser(size_t index, const ByteView& blob, size_t offset);
+
+    std::vector<ResultSink*> sinks;
     std::vector<std::unique_ptr<BaseParser>> parsers;
+    std::array<std::vector<size_t>, 256> dispatch;  // indices of the parsers to probe, by first byte
+    std::array<std::vector<size_t>, 256> unalignedDispatch;  // same without block-aligned parsers
+    std::vector<size_t> nextCandidate;  // per parser, skip hints of the blob being scanned
+    std::string currentSource;
+    uint32_t currentSourceId = 0;       // currentSource interned in store()
+    ResultId parentResult = NO_RESULT;  // in store(), the result this blob was extracted from
+    InputSource* streamInput = nullptr;  // during a streaming scan, maps offsets back to the file
+    SignatureIndex signatures;  // of the blob being scanned, see BaseParser::prepare
+    const bool* paddingBytes = nullptr;  // 256 entries: byte values safe to skip runs of
     std::vector<std::unique_ptr<BaseExtractor>> extractors;
+    std::vector<BudgetLimit> parserBudgets;  // per parser, from budgets
+    std::vector<ParserCounters> probeCounters;  // per parser, added to profile when a scan ends
+    std::vector<char> structured;  // per parser, needsStructuredData()
 };
\ No newline at end of file
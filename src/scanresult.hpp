@@ -1,17 +1,23 @@
 #pragma once
+#include "result_info.hpp"
 #include <string>
 #include <vector>
 #include <iostream>
 
+// One result as a parser reports it. Scanners keep their results in a
+// ResultStore, where the results found inside extracted artifacts become
+// its children.
 struct ScanResult {
     size_t offset;
     std::string type;
     std::string extractorType;
     size_t length;
-    std::string info;
+    ResultInfo info;
     std::string source;  // NEW: e.g., "ZIP:images/logo.jpg"
-    std::vector<ScanResult> children;  // 🧠 Nested scan results
     bool confident = true;
     bool extracted = false;
     bool isValid = false;
+    size_t nextCandidate = 0;  // skip hint: no match of this parser's type before this offset
+    bool needsMoreData = false;  // the blob ended before the parser could decide
+    bool budgetExceeded = false;  // parsing or extraction was cut short by a budget
 };
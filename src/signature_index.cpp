@@ -0,0 +1,76 @@
+#include "signature_index.hpp"
+#include <algorithm>
+
+SignatureSet& SignatureSet::instance() {
+    static SignatureSet set;
+    return set;
+}
+
+uint32_t SignatureSet::family(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find(families.begin(), families.end(), name);
+    if (it != families.end())
+        return static_cast<uint32_t>(it - families.begin());
+    families.push_back(name);
+    return static_cast<uint32_t>(families.size() - 1);
+}
+
+void SignatureSet::add(uint32_t family, const uint8_t* bytes, size_t len, uint32_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    automaton.add(bytes, len, static_cast<uint32_t>(entries.size()));
+    entries.push_back({family, id});
+    current.reset();
+}
+
+// Scans that already hold a snapshot keep using it; signatures added later
+// only reach the scans that start after them
+std::shared_ptr<const SignatureSet::Compiled> SignatureSet::compiled() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!current) {
+        auto built = std::make_shared<Compiled>();
+        built->entries = entries;
+        built->automaton = automaton;
+        built->automaton.build();
+        current = std::move(built);
+    }
+    return current;
+}
+
+void SignatureSet::match(const uint8_t* data, size_t size, std::vector<SignatureHit>& hits) {
+    std::shared_ptr<const Compiled> set = compiled();
+    set->automaton.scan(data, size, [&](size_t offset, uint32_t entry) {
+        hits.push_back({offset, set->entries[entry].family, set->entries[entry].id});
+    });
+}
+
+void SignatureIndex::build(const ByteView& blob) {
+    data = blob.data();
+    size = blob.size();
+    hits.clear();
+    SignatureSet::instance().match(blob.data(), blob.size(), hits);
+    std::sort(hits.begin(), hits.end(), [](const SignatureHit& a, const SignatureHit& b) {
+        if (a.offset != b.offset) return a.offset < b.offset;
+        if (a.family != b.family) return a.family < b.family;
+        return a.id < b.id;
+    });
+}
+
+const SignatureHit* SignatureIndex::at(size_t offset, uint32_t family) const {
+    auto it = std::lower_bound(hits.begin(), hits.end(), offset,
+        [](const SignatureHit& h, size_t off) { return h.offset < off; });
+    for (; it != hits.end() && it->offset == offset; ++it) {
+        if (it->family == family)
+            return &*it;
+    }
+    return nullptr;
+}
+
+size_t SignatureIndex::next(size_t offset, uint32_t family) const {
+    auto it = std::lower_bound(hits.begin(), hits.end(), offset,
+        [](const SignatureHit& h, size_t off) { return h.offset < off; });
+    for (; it != hits.end(); ++it) {
+        if (it->family == family)
+            return it->offset;
+    }
+    return size;
+}
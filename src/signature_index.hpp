@@ -0,0 +1,76 @@
+#pragma once
+#include "byte_view.hpp"
+#include "aho_corasick.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct SignatureHit {
+    size_t offset;
+    uint32_t family;   // SignatureSet::family id
+    uint32_t id;       // id given by the family when the signature was added
+};
+
+// Process-wide set of fixed byte signatures that are located in a single
+// pass per blob. Parsers group their signatures in named families and add
+// them before the first scan, typically from their constructor.
+//
+// Scanners on several threads share the set. The automaton is built once,
+// under the lock, by the first match() after signatures were added, and
+// published as an immutable snapshot; match() only reads it.
+class SignatureSet {
+public:
+    static SignatureSet& instance();
+
+    uint32_t family(const std::string& name);
+    void add(uint32_t family, const uint8_t* bytes, size_t len, uint32_t id);
+
+    // Finds every signature in data[0..size), unordered
+    void match(const uint8_t* data, size_t size, std::vector<SignatureHit>& hits);
+
+private:
+    struct Entry {
+        uint32_t family;
+        uint32_t id;
+    };
+    struct Compiled {
+        std::vector<Entry> entries;
+        AhoCorasick automaton;
+    };
+    std::shared_ptr<const Compiled> compiled();
+
+    std::mutex mutex;  // guards everything below
+    std::vector<std::string> families;
+    std::vector<Entry> entries;
+    AhoCorasick automaton;  // the added patterns, not built
+    std::shared_ptr<const Compiled> current;  // null until built, reset by add()
+};
+
+// Signature hits of one blob, sorted by offset, built once before the scan
+// loop and handed to the parsers through BaseParser::prepare.
+class SignatureIndex {
+public:
+    void build(const ByteView& blob);
+
+    // True if the index was built for this blob (parsers are also called on
+    // other buffers, e.g. by the padding self-test)
+    bool covers(const ByteView& blob) const {
+        return blob.data() == data && blob.size() == size;
+    }
+
+    // Hit of `family` starting exactly at `offset` with the lowest id
+    const SignatureHit* at(size_t offset, uint32_t family) const;
+    // Offset of the first hit of `family` at or after `offset`, or the blob
+    // size if there is none
+    size_t next(size_t offset, uint32_t family) const;
+
+    const std::vector<SignatureHit>& all() const { return hits; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    std::vector<SignatureHit> hits;
+};
@@ -0,0 +1,65 @@
+#include "aho_corasick.hpp"
+#include <queue>
+
+void AhoCorasick::add(const uint8_t* pattern, size_t len, uint32_t id) {
+    if (len == 0) return;
+    if (trie.empty()) {
+        trie.assign(256, 0);
+        pending.emplace_back();
+    }
+
+    uint32_t state = 0;
+    for (size_t i = 0; i < len; ++i) {
+        size_t e = (static_cast<size_t>(state) << 8) | pattern[i];
+        if (trie[e] == 0) {
+            trie[e] = static_cast<uint32_t>(pending.size());
+            pending.emplace_back();
+            trie.resize(trie.size() + 256, 0);
+        }
+        state = trie[e];
+    }
+    pending[state].push_back({id, static_cast<uint32_t>(len)});
+    ++patternCount;
+    built = false;
+}
+
+// Turns the trie into a DFA: missing edges follow the failure links, and
+// every state inherits the outputs of its failure state.
+void AhoCorasick::build() {
+    if (patternCount == 0) return;
+    size_t states = pending.size();
+    std::vector<uint32_t> fail(states, 0);
+    std::vector<std::vector<Match>> out = pending;
+    next = trie;
+
+    std::queue<uint32_t> queue;
+    for (int b = 0; b < 256; ++b) {
+        if (trie[b]) queue.push(trie[b]);
+    }
+    while (!queue.empty()) {
+        uint32_t s = queue.front();
+        queue.pop();
+        const std::vector<Match>& inherited = out[fail[s]];
+        out[s].insert(out[s].end(), inherited.begin(), inherited.end());
+        for (int b = 0; b < 256; ++b) {
+            size_t e = (static_cast<size_t>(s) << 8) | b;
+            uint32_t f = next[(static_cast<size_t>(fail[s]) << 8) | b];
+            if (trie[e]) {
+                fail[trie[e]] = f;
+                queue.push(trie[e]);
+            } else {
+                next[e] = f;
+            }
+        }
+    }
+
+    outStart.assign(states, 0);
+    outCount.assign(states, 0);
+    outputs.clear();
+    for (size_t s = 0; s < states; ++s) {
+        outStart[s] = static_cast<uint32_t>(outputs.size());
+        outCount[s] = static_cast<uint32_t>(out[s].size());
+        outputs.insert(outputs.end(), out[s].begin(), out[s].end());
+    }
+    built = true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Multi-pattern byte matcher. After build() the automaton is a dense DFA,
+// so scanning costs one table lookup per input byte no matter how many
+// patterns were added.
+class AhoCorasick {
+public:
+    struct Match {
+        uint32_t id;
+        uint32_t length;
+    };
+
+    void add(const uint8_t* pattern, size_t len, uint32_t id);
+    void build();
+    bool empty() const { return patternCount == 0; }
+
+    // Calls fn(startOffset, id) for every occurrence, ordered by end offset
+    template <typename F>
+    void scan(const uint8_t* data, size_t size, F&& fn) const {
+        if (!built || patternCount == 0) return;
+        uint32_t state = 0;
+        for (size_t i = 0; i < size; ++i) {
+            state = next[(static_cast<size_t>(state) << 8) | data[i]];
+            if (outCount[state]) {
+                const Match* m = &outputs[outStart[state]];
+                for (uint32_t k = 0; k < outCount[state]; ++k)
+                    fn(i + 1 - m[k].length, m[k].id);
+            }
+        }
+    }
+
+private:
+    std::vector<uint32_t> trie;       // state * 256 + byte -> child, 0 if none
+    std::vector<uint32_t> next;       // DFA transitions, derived from trie
+    std::vector<uint32_t> outStart;   // per state, into outputs
+    std::vector<uint32_t> outCount;
+    std::vector<Match> outputs;
+    std::vector<std::vector<Match>> pending;  // per trie state, before build()
+    size_t patternCount = 0;
+    bool built = false;
+};
@@ -0,0 +1,171 @@
+#include "budget.hpp"
+#include "logger.hpp"
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+
+thread_local Budget* current = nullptr;
+
+// "500ms", "2s", "4096", "64K", "1G"
+bool parseLimitPart(const std::string& text, BudgetLimit& limit) {
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (end == text.c_str())
+        return false;
+    std::string unit(end);
+    for (auto& c : unit)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    if (unit == "ms")
+        limit.millis = value;
+    else if (unit == "s")
+        limit.millis = value * 1000;
+    else if (unit.empty())
+        limit.bytes = value;
+    else if (unit == "k")
+        limit.bytes = value << 10;
+    else if (unit == "m")
+        limit.bytes = value << 20;
+    else if (unit == "g")
+        limit.bytes = value << 30;
+    else
+        return false;
+    return true;
+}
+
+bool parseLimit(const std::string& text, BudgetLimit& limit) {
+    limit = {};
+    std::istringstream parts(text);
+    std::string part;
+    bool any = false;
+    while (std::getline(parts, part, ':')) {
+        if (part.empty())
+            continue;
+        if (!parseLimitPart(part, limit))
+            return false;
+        any = true;
+    }
+    return any;
+}
+
+} // namespace
+
+bool BudgetConfig::empty() const {
+    return scan.unlimited() && parser.unlimited() && extractor.unlimited() &&
+           parsers.empty() && extractors.empty();
+}
+
+BudgetLimit BudgetConfig::forParser(const std::string& name) const {
+    auto it = parsers.find(name);
+    return it != parsers.end() ? it->second : parser;
+}
+
+BudgetLimit BudgetConfig::forExtractor(const std::string& name) const {
+    auto it = extractors.find(name);
+    return it != extractors.end() ? it->second : extractor;
+}
+
+bool parseBudgets(const std::string& spec, BudgetConfig& config) {
+    std::istringstream entries(spec);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        if (entry.empty())
+            continue;
+        size_t eq = entry.find('=');
+        BudgetLimit limit;
+        if (eq == std::string::npos || !parseLimit(entry.substr(eq + 1), limit)) {
+            Logger::error("Invalid budget " + entry + ", expected KEY=TIME, KEY=SIZE or KEY=TIME:SIZE");
+            return false;
+        }
+        std::string key = entry.substr(0, eq);
+        if (key == "scan")
+            config.scan = limit;
+        else if (key == "parser")
+            config.parser = limit;
+        else if (key == "extractor")
+            config.extractor = limit;
+        else if (key.rfind("parser.", 0) == 0)
+            config.parsers[key.substr(7)] = limit;
+        else if (key.rfind("extractor.", 0) == 0)
+            config.extractors[key.substr(10)] = limit;
+        else {
+            Logger::error("Unknown budget " + key + ", expected scan, parser, extractor, parser.NAME or extractor.NAME");
+            return false;
+        }
+    }
+    return true;
+}
+
+Budget::Budget(const BudgetLimit& limit, Budget* parent, bool chargeParent)
+    : millis(limit.millis), maxBytes(limit.bytes), parent(parent), chargeParent(chargeParent) {
+    if (millis)
+        deadline = Clock::now() + std::chrono::milliseconds(millis);
+}
+
+bool Budget::trip(State s) {
+    int expected = NONE;
+    state.compare_exchange_strong(expected, s, std::memory_order_relaxed);
+    return false;
+}
+
+bool Budget::charge(uint64_t bytes) {
+    uint64_t total = spent.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (parent && chargeParent && !parent->charge(bytes))
+        return trip(PARENT);
+    if (maxBytes && total > maxBytes)
+        return trip(BYTES);
+    return ok();
+}
+
+bool Budget::ok() {
+    if (exceeded())
+        return false;
+    if (maxBytes && used() > maxBytes)
+        return trip(BYTES);
+    if (millis && Clock::now() >= deadline)
+        return trip(TIME);
+    if (parent && (chargeParent ? !parent->ok() : parent->expired()))
+        return trip(PARENT);
+    return true;
+}
+
+bool Budget::expired() {
+    int s = state.load(std::memory_order_relaxed);
+    if (s == TIME)
+        return true;
+    if (millis && Clock::now() >= deadline) {
+        trip(TIME);
+        return true;
+    }
+    if (parent && parent->expired()) {
+        trip(PARENT);
+        return true;
+    }
+    return false;
+}
+
+std::string Budget::reason() const {
+    switch (state.load(std::memory_order_relaxed)) {
+    case TIME:
+        return "time limit of " + std::to_string(millis) + " ms";
+    case BYTES:
+        return "limit of " + std::to_string(maxBytes) + " bytes";
+    case PARENT:
+        return parent->reason();
+    default:
+        return "";
+    }
+}
+
+Budget* currentBudget() {
+    return current;
+}
+
+BudgetScope::BudgetScope(Budget* budget) : previous(current) {
+    current = budget;
+}
+
+BudgetScope::~BudgetScope() {
+    current = previous;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Time and byte limit of one piece of work, 0 = unlimited
+struct BudgetLimit {
+    uint64_t millis = 0;
+    uint64_t bytes = 0;
+    bool unlimited() const { return millis == 0 && bytes == 0; }
+};
+
+// Budgets of a scan (--budget):
+//   scan        the top-level scan with all nested ones; bytes are the total
+//               written by extractors
+//   parser      each parser call; bytes are what it decodes to validate a
+//               candidate, e.g. the inflated size of a GZIP stream
+//   extractor   each extraction; bytes are what it writes
+// Single parsers and extractors can be given their own limits by name.
+struct BudgetConfig {
+    BudgetLimit scan;
+    BudgetLimit parser;
+    BudgetLimit extractor;
+    std::map<std::string, BudgetLimit> parsers;     // by BaseParser::name()
+    std::map<std::string, BudgetLimit> extractors;  // by BaseExtractor::name()
+
+    bool empty() const;
+    BudgetLimit forParser(const std::string& name) const;
+    BudgetLimit forExtractor(const std::string& name) const;
+};
+
+// Parses "KEY=LIMIT[,KEY=LIMIT...]". KEY is scan, parser, extractor,
+// parser.NAME or extractor.NAME; LIMIT is a time (500ms, 2s), a size in
+// bytes (64M, optional K/M/G suffix) or both joined by ':'.
+// Logs and returns false on errors.
+bool parseBudgets(const std::string& spec, BudgetConfig& config);
+
+// Running budget of one piece of work. Nothing is interrupted: long loops
+// charge what they produce or ask whether they may go on, and stop early
+// when the answer is no. A budget with a parent also ends when the parent's
+// deadline passes, and with `chargeParent` its bytes count there too.
+// charge() and ok() may be called from several threads.
+class Budget {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Budget(const BudgetLimit& limit = {}, Budget* parent = nullptr, bool chargeParent = false);
+
+    // Counts `bytes` of output, false once the budget is exceeded
+    bool charge(uint64_t bytes);
+    // False once the budget is exceeded
+    bool ok();
+    // Whether the deadline has passed, here or in a parent
+    bool expired();
+    // Whether charge(), ok() or expired() found the budget exceeded
+    bool exceeded() const { return state.load(std::memory_order_relaxed) != NONE; }
+    uint64_t used() const { return spent.load(std::memory_order_relaxed); }
+    // What was exceeded, e.g. "time limit of 200 ms"
+    std::string reason() const;
+
+private:
+    enum State : int { NONE, TIME, BYTES, PARENT };
+    bool trip(State s);
+
+    Clock::time_point deadline = Clock::time_point::max();
+    uint64_t millis;
+    uint64_t maxBytes;
+    Budget* parent;
+    bool chargeParent;
+    std::atomic<uint64_t> spent{0};
+    std::atomic<int> state{NONE};
+};
+
+// The budget charged by parsers and extractors running on this thread,
+// nullptr when unlimited. The scanner installs one around every parser
+// and extractor call.
+Budget* currentBudget();
+
+class BudgetScope {
+public:
+    explicit BudgetScope(Budget* budget);
+    ~BudgetScope();
+    BudgetScope(const BudgetScope&) = delete;
+    BudgetScope& operator=(const BudgetScope&) = delete;
+
+private:
+    Budget* previous;
+};
+
+// For the loops themselves: true while work may continue
+inline bool budgetCharge(uint64_t bytes) {
+    Budget* budget = currentBudget();
+    return !budget || budget->charge(bytes);
+}
+
+inline bool budgetOk() {
+    Budget* budget = currentBudget();
+    return !budget || budget->ok();
+}
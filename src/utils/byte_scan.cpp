@@ -0,0 +1,136 @@
+#include "byte_scan.hpp"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HEXDIG_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+size_t runLengthScalar(const uint8_t* p, size_t n, uint8_t value) {
+    const uint64_t pattern = 0x0101010101010101ULL * value;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, p + i, sizeof(w));
+        uint64_t diff = w ^ pattern;
+        if (diff)
+            return i + (__builtin_ctzll(diff) >> 3);
+    }
+    while (i < n && p[i] == value) ++i;
+    return i;
+}
+
+#ifdef HEXDIG_X86_SIMD
+__attribute__((target("sse2")))
+size_t runLengthSSE2(const uint8_t* p, size_t n, uint8_t value) {
+    const __m128i pattern = _mm_set1_epi8(static_cast<char>(value));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, pattern)));
+        if (mask != 0xFFFFu)
+            return i + __builtin_ctz(~mask);
+    }
+    return i + runLengthScalar(p + i, n - i, value);
+}
+
+__attribute__((target("avx2")))
+size_t runLengthAVX2(const uint8_t* p, size_t n, uint8_t value) {
+    const __m256i pattern = _mm256_set1_epi8(static_cast<char>(value));
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, pattern)));
+        if (mask != 0xFFFFFFFFu)
+            return i + __builtin_ctz(~mask);
+    }
+    return i + runLengthSSE2(p + i, n - i, value);
+}
+#endif
+
+using RunLengthFn = size_t (*)(const uint8_t*, size_t, uint8_t);
+
+RunLengthFn selectRunLength() {
+#ifdef HEXDIG_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return runLengthAVX2;
+    if (__builtin_cpu_supports("sse2")) return runLengthSSE2;
+#endif
+    return runLengthScalar;
+}
+
+const RunLengthFn runLengthImpl = selectRunLength();
+
+size_t pairScalar(const uint8_t* p, size_t n, uint8_t a, uint8_t b) {
+    if (n < 2) return n;
+    size_t i = 0;
+    while (i + 1 < n) {
+        const void* hit = std::memchr(p + i, a, n - 1 - i);
+        if (!hit) break;
+        i = static_cast<size_t>(static_cast<const uint8_t*>(hit) - p);
+        if (p[i + 1] == b) return i;
+        ++i;
+    }
+    return n;
+}
+
+#ifdef HEXDIG_X86_SIMD
+__attribute__((target("sse2")))
+size_t pairSSE2(const uint8_t* p, size_t n, uint8_t a, uint8_t b) {
+    const __m128i va = _mm_set1_epi8(static_cast<char>(a));
+    const __m128i vb = _mm_set1_epi8(static_cast<char>(b));
+    size_t i = 0;
+    for (; i + 17 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(x, va), _mm_cmpeq_epi8(y, vb))));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    size_t rest = pairScalar(p + i, n - i, a, b);
+    return rest == n - i ? n : i + rest;
+}
+
+__attribute__((target("avx2")))
+size_t pairAVX2(const uint8_t* p, size_t n, uint8_t a, uint8_t b) {
+    const __m256i va = _mm256_set1_epi8(static_cast<char>(a));
+    const __m256i vb = _mm256_set1_epi8(static_cast<char>(b));
+    size_t i = 0;
+    for (; i + 33 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + 1));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(x, va), _mm256_cmpeq_epi8(y, vb))));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    size_t rest = pairSSE2(p + i, n - i, a, b);
+    return rest == n - i ? n : i + rest;
+}
+#endif
+
+using PairFn = size_t (*)(const uint8_t*, size_t, uint8_t, uint8_t);
+
+PairFn selectPair() {
+#ifdef HEXDIG_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return pairAVX2;
+    if (__builtin_cpu_supports("sse2")) return pairSSE2;
+#endif
+    return pairScalar;
+}
+
+const PairFn pairImpl = selectPair();
+
+} // namespace
+
+size_t find_byte_pair(const uint8_t* p, size_t n, uint8_t a, uint8_t b) {
+    return pairImpl(p, n, a, b);
+}
+
+size_t uniform_run_length(const uint8_t* p, size_t n, uint8_t value) {
+    return runLengthImpl(p, n, value);
+}
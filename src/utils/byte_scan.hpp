@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+//
+// Vectorised byte search primitives used by the scan loop and parsers. The widest
+// implementation supported by the CPU (AVX2, SSE2, then portable scalar) is
+// picked once at startup.
+//
+
+// Number of consecutive bytes equal to `value` at the start of p[0..n)
+size_t uniform_run_length(const uint8_t* p, size_t n, uint8_t value);
+
+// Offset of the first position i with p[i] == a && p[i+1] == b, or n if none
+size_t find_byte_pair(const uint8_t* p, size_t n, uint8_t a, uint8_t b);
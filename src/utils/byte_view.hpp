@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Read-only view of bytes owned elsewhere: a std::vector, a memory-mapped
+// file or a buffer of an application embedding libhexdig. Parsers and
+// extractors take their input as a view, so data is scanned where it lies.
+// The view does not own the bytes; they must outlive it.
+class ByteView {
+public:
+    using value_type = std::uint8_t;
+    using const_iterator = const std::uint8_t*;
+    using iterator = const_iterator;
+
+    ByteView() = default;
+    ByteView(const std::uint8_t* data, size_t size) : ptr(data), len(size) {}
+    ByteView(const std::vector<std::uint8_t>& bytes) : ptr(bytes.data()), len(bytes.size()) {}
+
+    const std::uint8_t* data() const { return ptr; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    const_iterator begin() const { return ptr; }
+    const_iterator end() const { return ptr + len; }
+    const std::uint8_t& operator[](size_t i) const { return ptr[i]; }
+
+    // Bytes [offset, offset + count), clamped to the view
+    ByteView subview(size_t offset, size_t count = SIZE_MAX) const {
+        if (offset > len)
+            offset = len;
+        if (count > len - offset)
+            count = len - offset;
+        return ByteView(ptr + offset, count);
+    }
+
+private:
+    const std::uint8_t* ptr = nullptr;
+    size_t len = 0;
+};
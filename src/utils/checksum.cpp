@@ -0,0 +1,284 @@
+#include "checksum.hpp"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HEXDIG_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define HEXDIG_LITTLE_ENDIAN 1
+#endif
+
+namespace {
+
+// Slice-by-8 tables for a reflected CRC of width T: table[0] is the classic
+// byte table, table[k] advances a byte through k further zero bytes.
+template <typename T>
+struct ReflectedTables {
+    T table[8][256];
+
+    explicit ReflectedTables(T poly) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            T c = static_cast<T>(i);
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? static_cast<T>((c >> 1) ^ poly) : static_cast<T>(c >> 1);
+            table[0][i] = c;
+        }
+        for (int k = 1; k < 8; ++k)
+            for (int i = 0; i < 256; ++i)
+                table[k][i] = static_cast<T>((table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF]);
+    }
+
+    // Raw register update, no pre/post inversion
+    T update(T crc, const uint8_t* p, size_t len) const {
+#ifdef HEXDIG_LITTLE_ENDIAN
+        while (len >= 8) {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            v ^= crc;
+            crc = static_cast<T>(
+                table[7][v & 0xFF] ^ table[6][(v >> 8) & 0xFF] ^
+                table[5][(v >> 16) & 0xFF] ^ table[4][(v >> 24) & 0xFF] ^
+                table[3][(v >> 32) & 0xFF] ^ table[2][(v >> 40) & 0xFF] ^
+                table[1][(v >> 48) & 0xFF] ^ table[0][v >> 56]);
+            p += 8;
+            len -= 8;
+        }
+#endif
+        while (len--)
+            crc = static_cast<T>((crc >> 8) ^ table[0][(crc ^ *p++) & 0xFF]);
+        return crc;
+    }
+};
+
+// Slice-by-8 for the MSB-first CRC-32
+struct MsbTables {
+    uint32_t table[8][256];
+
+    MsbTables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i << 24;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 0x80000000u) ? (c << 1) ^ 0x04C11DB7u : (c << 1);
+            table[0][i] = c;
+        }
+        for (int k = 1; k < 8; ++k)
+            for (int i = 0; i < 256; ++i)
+                table[k][i] = (table[k - 1][i] << 8) ^ table[0][table[k - 1][i] >> 24];
+    }
+
+    uint32_t update(uint32_t crc, const uint8_t* p, size_t len) const {
+        while (len >= 8) {
+            uint32_t a = ((uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+                          (uint32_t(p[2]) << 8) | p[3]) ^ crc;
+            uint32_t b = (uint32_t(p[4]) << 24) | (uint32_t(p[5]) << 16) |
+                         (uint32_t(p[6]) << 8) | p[7];
+            crc = table[7][a >> 24] ^ table[6][(a >> 16) & 0xFF] ^
+                  table[5][(a >> 8) & 0xFF] ^ table[4][a & 0xFF] ^
+                  table[3][b >> 24] ^ table[2][(b >> 16) & 0xFF] ^
+                  table[1][(b >> 8) & 0xFF] ^ table[0][b & 0xFF];
+            p += 8;
+            len -= 8;
+        }
+        while (len--)
+            crc = (crc << 8) ^ table[0][(crc >> 24) ^ *p++];
+        return crc;
+    }
+};
+
+const ReflectedTables<uint32_t>& crc32Tables() {
+    static const ReflectedTables<uint32_t> t(0xEDB88320u);
+    return t;
+}
+
+const ReflectedTables<uint32_t>& crc32cTables() {
+    static const ReflectedTables<uint32_t> t(0x82F63B78u);
+    return t;
+}
+
+const ReflectedTables<uint16_t>& crc16Tables() {
+    static const ReflectedTables<uint16_t> t(0xA001);
+    return t;
+}
+
+const MsbTables& msbTables() {
+    static const MsbTables t;
+    return t;
+}
+
+uint32_t crc32Table(uint32_t crc, const uint8_t* p, size_t len) {
+    return crc32Tables().update(crc, p, len);
+}
+
+uint32_t crc32cTable(uint32_t crc, const uint8_t* p, size_t len) {
+    return crc32cTables().update(crc, p, len);
+}
+
+#ifdef HEXDIG_X86_SIMD
+// CRC-32 by carry-less multiplication folding (Intel, "Fast CRC Computation
+// for Generic Polynomials Using PCLMULQDQ"), four 128-bit lanes folded 64
+// bytes at a time, then Barrett-reduced to 32 bits. `len` must be a multiple
+// of 16 and at least 64.
+__attribute__((target("pclmul,sse4.1")))
+uint32_t crc32Fold(uint32_t crc, const uint8_t* buf, size_t len) {
+    alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    buf += 64;
+    len -= 64;
+
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        y5 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+        y6 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+        y7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+        y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+        buf += 64;
+        len -= 64;
+    }
+
+    // Fold the four lanes into one
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    const __m128i lanes[3] = {x2, x3, x4};
+    for (const __m128i& next : lanes) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, next), x5);
+    }
+
+    while (len >= 16) {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        buf += 16;
+        len -= 16;
+    }
+
+    // 128 -> 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+__attribute__((target("pclmul,sse4.1")))
+uint32_t crc32Pclmul(uint32_t crc, const uint8_t* p, size_t len) {
+    if (len >= 64) {
+        size_t chunk = len & ~size_t(15);
+        crc = crc32Fold(crc, p, chunk);
+        p += chunk;
+        len -= chunk;
+    }
+    return crc32Table(crc, p, len);
+}
+
+__attribute__((target("sse4.2")))
+uint32_t crc32cHardware(uint32_t crc, const uint8_t* p, size_t len) {
+#ifdef __x86_64__
+    uint64_t c = crc;
+    while (len >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        len -= 8;
+    }
+    crc = static_cast<uint32_t>(c);
+#endif
+    while (len--)
+        crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+#endif
+
+using CrcFn = uint32_t (*)(uint32_t, const uint8_t*, size_t);
+
+CrcFn selectCrc32() {
+#ifdef HEXDIG_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1"))
+        return crc32Pclmul;
+#endif
+    return crc32Table;
+}
+
+CrcFn selectCrc32c() {
+#ifdef HEXDIG_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return crc32cHardware;
+#endif
+    return crc32cTable;
+}
+
+const CrcFn crc32Impl = selectCrc32();
+const CrcFn crc32cImpl = selectCrc32c();
+
+} // namespace
+
+uint32_t crc32_ieee(const uint8_t* data, size_t len, uint32_t crc) {
+    return ~crc32Impl(~crc, data, len);
+}
+
+uint32_t crc32c(const uint8_t* data, size_t len, uint32_t crc) {
+    return ~crc32cImpl(~crc, data, len);
+}
+
+uint32_t crc32_msb(const uint8_t* data, size_t len, uint32_t crc) {
+    return ~msbTables().update(~crc, data, len);
+}
+
+uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc) {
+    return crc16Tables().update(crc, data, len);
+}
+
+uint32_t crc32_ieee_portable(const uint8_t* data, size_t len, uint32_t crc) {
+    return ~crc32Table(~crc, data, len);
+}
+
+uint32_t crc32c_portable(const uint8_t* data, size_t len, uint32_t crc) {
+    return ~crc32cTable(~crc, data, len);
+}
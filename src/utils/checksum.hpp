@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+//
+// Checksums shared by all parsers and extractors. The fastest implementation
+// the CPU supports is picked once at startup: PCLMULQDQ folding for CRC-32,
+// the SSE4.2 crc32 instruction for CRC-32C, slice-by-8 tables otherwise.
+//
+// `crc` is the result of a previous call, so large inputs can be processed
+// in pieces; pass 0 (the default) to start.
+//
+
+// CRC-32 (IEEE 802.3, reflected), as used by zlib, gzip, PNG, XZ and ZIP
+uint32_t crc32_ieee(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+// CRC-32C (Castagnoli, reflected), as used by ext4, btrfs and iSCSI
+uint32_t crc32c(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+// Non-reflected CRC-32 (poly 0x04C11DB7, MSB first), as used by bzip2
+uint32_t crc32_msb(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+// CRC-16/ARC (poly 0x8005 reflected, init 0)
+uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc = 0);
+
+// The table implementations of crc32_ieee and crc32c whatever the CPU
+// supports, the reference the hardware paths are tested against
+uint32_t crc32_ieee_portable(const uint8_t* data, size_t len, uint32_t crc = 0);
+uint32_t crc32c_portable(const uint8_t* data, size_t len, uint32_t crc = 0);
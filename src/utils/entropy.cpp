@@ -0,0 +1,208 @@
+#include "entropy.hpp"
+#include "thread_pool.hpp"
+#include "logger.hpp"
+#include "cJSON.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <future>
+
+namespace {
+
+// Byte histogram using four interleaved count tables, so consecutive equal
+// bytes do not serialise on the same counter, unrolled 16 bytes per step.
+void histogram(const uint8_t* p, size_t n, uint32_t out[256]) {
+    uint32_t c[4][256];
+    std::memset(c, 0, sizeof(c));
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint64_t a, b;
+        std::memcpy(&a, p + i, 8);
+        std::memcpy(&b, p + i + 8, 8);
+        for (int k = 0; k < 8; k += 4) {
+            ++c[0][(a >> (k * 8)) & 0xFF];
+            ++c[1][(a >> (k * 8 + 8)) & 0xFF];
+            ++c[2][(a >> (k * 8 + 16)) & 0xFF];
+            ++c[3][(a >> (k * 8 + 24)) & 0xFF];
+            ++c[0][(b >> (k * 8)) & 0xFF];
+            ++c[1][(b >> (k * 8 + 8)) & 0xFF];
+            ++c[2][(b >> (k * 8 + 16)) & 0xFF];
+            ++c[3][(b >> (k * 8 + 24)) & 0xFF];
+        }
+    }
+    for (; i < n; ++i)
+        ++c[0][p[i]];
+
+    for (int v = 0; v < 256; ++v)
+        out[v] = c[0][v] + c[1][v] + c[2][v] + c[3][v];
+}
+
+float shannon(const uint32_t counts[256], size_t n) {
+    if (n == 0) return 0.0f;
+    double e = 0.0;
+    const double inv = 1.0 / static_cast<double>(n);
+    for (int v = 0; v < 256; ++v) {
+        if (!counts[v]) continue;
+        double p = counts[v] * inv;
+        e -= p * std::log2(p);
+    }
+    return static_cast<float>(e);
+}
+
+void computeRange(const uint8_t* data, size_t blockSize, size_t count, float* out) {
+    uint32_t counts[256];
+    for (size_t b = 0; b < count; ++b) {
+        histogram(data + b * blockSize, blockSize, counts);
+        out[b] = shannon(counts, blockSize);
+    }
+}
+
+void buildRegions(EntropyProfile& profile, size_t size) {
+    const auto& e = profile.blocks;
+    profile.inHighRegion.assign(e.size(), 0);
+
+    size_t i = 0;
+    while (i < e.size()) {
+        bool high = e[i] >= ENTROPY_HIGH_RISING;
+        bool low = e[i] <= ENTROPY_LOW_MAX;
+        if (!high && !low) { ++i; continue; }
+
+        size_t j = i;
+        double sum = 0.0;
+        while (j < e.size() && (high ? e[j] >= ENTROPY_HIGH_FALLING : e[j] <= ENTROPY_LOW_MAX)) {
+            sum += e[j];
+            if (high) profile.inHighRegion[j] = 1;
+            ++j;
+        }
+
+        EntropyRegion r;
+        r.offset = i * profile.blockSize;
+        r.length = std::min(j * profile.blockSize, size) - r.offset;
+        r.high = high;
+        r.average = sum / static_cast<double>(j - i);
+        profile.regions.push_back(r);
+        i = j;
+    }
+}
+
+} // namespace
+
+EntropyAnalyzer::EntropyAnalyzer(size_t blockSize, ThreadPool* pool) : pool(pool) {
+    profile.blockSize = blockSize ? blockSize : 1024;
+    carry.reserve(profile.blockSize);
+}
+
+void EntropyAnalyzer::addBlocks(const uint8_t* data, size_t count) {
+    size_t first = profile.blocks.size();
+    profile.blocks.resize(first + count);
+    float* out = profile.blocks.data() + first;
+    size_t bs = profile.blockSize;
+
+    // Chunks of at least 1 MiB keep task overhead negligible
+    size_t blocksPerChunk = std::max<size_t>(1, (size_t(1) << 20) / bs);
+    if (!pool || pool->size() < 2 || count <= blocksPerChunk) {
+        computeRange(data, bs, count, out);
+        return;
+    }
+
+    std::vector<std::future<void>> pending;
+    for (size_t b = 0; b < count; b += blocksPerChunk) {
+        size_t n = std::min(blocksPerChunk, count - b);
+        pending.push_back(pool->submit([=] { computeRange(data + b * bs, bs, n, out + b); }));
+    }
+    for (auto& f : pending)
+        pool->wait(f);
+}
+
+void EntropyAnalyzer::update(const uint8_t* data, size_t len) {
+    size_t bs = profile.blockSize;
+    total += len;
+
+    if (!carry.empty()) {
+        size_t fill = std::min(bs - carry.size(), len);
+        carry.insert(carry.end(), data, data + fill);
+        data += fill;
+        len -= fill;
+        if (carry.size() < bs)
+            return;
+        addBlocks(carry.data(), 1);
+        carry.clear();
+    }
+
+    size_t whole = len / bs;
+    if (whole)
+        addBlocks(data, whole);
+    carry.assign(data + whole * bs, data + len);
+}
+
+EntropyProfile EntropyAnalyzer::finish() {
+    if (!carry.empty()) {
+        uint32_t counts[256];
+        histogram(carry.data(), carry.size(), counts);
+        profile.blocks.push_back(shannon(counts, carry.size()));
+        carry.clear();
+    }
+    buildRegions(profile, total);
+    return std::move(profile);
+}
+
+EntropyProfile computeEntropy(const uint8_t* data, size_t size, size_t blockSize, ThreadPool* pool) {
+    EntropyAnalyzer analyzer(blockSize, pool);
+    analyzer.update(data, size);
+    return analyzer.finish();
+}
+
+bool writeEntropy(const EntropyProfile& profile, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        Logger::error("Cannot write entropy output " + path);
+        return false;
+    }
+
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (json) {
+        cJSON* root = cJSON_CreateObject();
+        cJSON_AddNumberToObject(root, "blockSize", static_cast<double>(profile.blockSize));
+        cJSON* blocks = cJSON_CreateArray();
+        for (float e : profile.blocks)
+            cJSON_AddItemToArray(blocks, cJSON_CreateNumber(std::round(e * 10000.0) / 10000.0));
+        cJSON_AddItemToObject(root, "entropy", blocks);
+        cJSON* regions = cJSON_CreateArray();
+        for (const auto& r : profile.regions) {
+            cJSON* item = cJSON_CreateObject();
+            cJSON_AddNumberToObject(item, "offset", static_cast<double>(r.offset));
+            cJSON_AddNumberToObject(item, "length", static_cast<double>(r.length));
+            cJSON_AddStringToObject(item, "kind", r.high ? "high" : "low");
+            cJSON_AddNumberToObject(item, "average", std::round(r.average * 10000.0) / 10000.0);
+            cJSON_AddItemToArray(regions, item);
+        }
+        cJSON_AddItemToObject(root, "regions", regions);
+        char* text = cJSON_Print(root);
+        out.write(text, static_cast<std::streamsize>(std::strlen(text)));
+        free(text);
+        cJSON_Delete(root);
+        return static_cast<bool>(out);
+    }
+
+    // CSV: one row per block; the region column marks the block's region
+    std::vector<const char*> kind(profile.blocks.size(), "");
+    for (const auto& r : profile.regions) {
+        for (size_t b = r.offset / profile.blockSize;
+             b < kind.size() && b * profile.blockSize < r.offset + r.length; ++b)
+            kind[b] = r.high ? "high" : "low";
+    }
+
+    std::string buf = "offset,entropy,region\n";
+    char line[64];
+    for (size_t b = 0; b < profile.blocks.size(); ++b) {
+        std::snprintf(line, sizeof(line), "%zu,%.4f,", b * profile.blockSize, profile.blocks[b]);
+        buf += line;
+        buf += kind[b];
+        buf += '\n';
+    }
+    out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    return static_cast<bool>(out);
+}
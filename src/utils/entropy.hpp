@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+struct EntropyRegion {
+    size_t offset;
+    size_t length;
+    bool high;       // true: compressed/encrypted-looking, false: low entropy
+    double average;  // mean entropy of the region, bits per byte
+};
+
+// Shannon entropy (bits per byte, 0..8) of consecutive fixed-size blocks and
+// the high/low-entropy regions derived from them.
+struct EntropyProfile {
+    size_t blockSize = 0;
+    std::vector<float> blocks;
+    std::vector<EntropyRegion> regions;
+    std::vector<uint8_t> inHighRegion;  // per block, for O(1) lookups
+
+    bool isHigh(size_t offset) const {
+        size_t b = offset / blockSize;
+        return b < inHighRegion.size() && inHighRegion[b];
+    }
+};
+
+// A block enters a high-entropy region at >= HIGH_RISING and the region
+// ends below HIGH_FALLING (hysteresis as in binwalk); blocks below LOW_MAX
+// form low-entropy regions. All values are in bits per byte.
+constexpr double ENTROPY_HIGH_RISING  = 0.95 * 8;
+constexpr double ENTROPY_HIGH_FALLING = 0.85 * 8;
+constexpr double ENTROPY_LOW_MAX      = 0.25 * 8;
+
+// Streaming entropy computation: data can be fed in pieces of any size, each
+// piece's complete blocks are split into chunks processed in parallel when a
+// pool is given, and a partial trailing block is carried to the next call.
+class EntropyAnalyzer {
+public:
+    explicit EntropyAnalyzer(size_t blockSize = 1024, ThreadPool* pool = nullptr);
+    void update(const uint8_t* data, size_t len);
+    EntropyProfile finish();
+
+private:
+    void addBlocks(const uint8_t* data, size_t count);
+
+    EntropyProfile profile;
+    ThreadPool* pool;
+    size_t total = 0;
+    std::vector<uint8_t> carry;
+};
+
+// Convenience wrapper for data that is already in memory
+EntropyProfile computeEntropy(const uint8_t* data, size_t size, size_t blockSize, ThreadPool* pool = nullptr);
+
+// Writes offset,entropy,region rows (CSV) or a JSON document, chosen by the
+// file extension.
+bool writeEntropy(const EntropyProfile& profile, const std::string& path);
@@ -1,8 +1,47 @@
 #include "file_reader.hpp"
 #include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 std::vector<uint8_t> readFile(const std::string& path) {
     std::ifstream file(path, std::ios::binary);
     return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)),
                                  std::istreambuf_iterator<char>());
 }
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (mapping)
+        munmap(mapping, mappedLength);
+#endif
+}
+
+bool MappedFile::open(const std::string& path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st{};
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            ::close(fd);
+            mapping = addr;
+            mappedLength = static_cast<size_t>(st.st_size);
+            bytes = ByteView(static_cast<const uint8_t*>(addr), mappedLength);
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    bytes = ByteView(fallback);
+    return true;
+}
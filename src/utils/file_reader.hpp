@@ -1,6 +1,27 @@
 #pragma once
+#include "byte_view.hpp"
 #include <vector>
 #include <string>
 #include <cstdint>
 
 std::vector<std::uint8_t> readFile(const std::string& path);
+
+// Read-only view of a whole file. Regular files are memory-mapped so they
+// are scanned in place; where mapping is not available the file is read
+// into memory instead.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    ByteView view() const { return bytes; }
+
+private:
+    void* mapping = nullptr;
+    size_t mappedLength = 0;
+    std::vector<std::uint8_t> fallback;
+    ByteView bytes;
+};
@@ -0,0 +1,227 @@
+#include "hash.hpp"
+#include <cstring>
+
+//
+// XXH64
+//
+namespace {
+
+constexpr uint64_t P1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t P3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t P4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t P5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t load64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t load32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t round64(uint64_t acc, uint64_t input) {
+    acc += input * P2;
+    acc = rotl(acc, 31);
+    return acc * P1;
+}
+
+inline uint64_t merge64(uint64_t acc, uint64_t val) {
+    acc ^= round64(0, val);
+    return acc * P1 + P4;
+}
+
+} // namespace
+
+XXHash64::XXHash64(uint64_t seed) : seed(seed) {
+    v[0] = seed + P1 + P2;
+    v[1] = seed + P2;
+    v[2] = seed;
+    v[3] = seed - P1;
+}
+
+void XXHash64::update(const uint8_t* data, size_t len) {
+    total += len;
+
+    if (tailLen + len < 32) {
+        std::memcpy(tail + tailLen, data, len);
+        tailLen += len;
+        return;
+    }
+
+    if (tailLen) {
+        size_t fill = 32 - tailLen;
+        std::memcpy(tail + tailLen, data, fill);
+        for (int i = 0; i < 4; ++i)
+            v[i] = round64(v[i], load64(tail + i * 8));
+        data += fill;
+        len -= fill;
+        tailLen = 0;
+    }
+
+    uint64_t v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+    while (len >= 32) {
+        v1 = round64(v1, load64(data));
+        v2 = round64(v2, load64(data + 8));
+        v3 = round64(v3, load64(data + 16));
+        v4 = round64(v4, load64(data + 24));
+        data += 32;
+        len -= 32;
+    }
+    v[0] = v1; v[1] = v2; v[2] = v3; v[3] = v4;
+
+    std::memcpy(tail, data, len);
+    tailLen = len;
+}
+
+uint64_t XXHash64::digest() const {
+    uint64_t h;
+    if (total >= 32) {
+        h = rotl(v[0], 1) + rotl(v[1], 7) + rotl(v[2], 12) + rotl(v[3], 18);
+        for (int i = 0; i < 4; ++i)
+            h = merge64(h, v[i]);
+    } else {
+        h = seed + P5;
+    }
+    h += total;
+
+    const uint8_t* p = tail;
+    size_t len = tailLen;
+    while (len >= 8) {
+        h ^= round64(0, load64(p));
+        h = rotl(h, 27) * P1 + P4;
+        p += 8;
+        len -= 8;
+    }
+    if (len >= 4) {
+        h ^= static_cast<uint64_t>(load32(p)) * P1;
+        h = rotl(h, 23) * P2 + P3;
+        p += 4;
+        len -= 4;
+    }
+    while (len--) {
+        h ^= (*p++) * P5;
+        h = rotl(h, 11) * P1;
+    }
+
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t xxhash64(const uint8_t* data, size_t len, uint64_t seed) {
+    XXHash64 h(seed);
+    h.update(data, len);
+    return h.digest();
+}
+
+//
+// SHA-256
+//
+namespace {
+
+constexpr uint32_t K256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline uint32_t rotr32(uint32_t x, int r) {
+    return (x >> r) | (x << (32 - r));
+}
+
+void sha256Block(uint32_t state[8], const uint8_t* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) |
+               (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+    }
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t S1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + S1 + ch + K256[i] + w[i];
+        uint32_t S0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = S0 + maj;
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+} // namespace
+
+std::array<uint8_t, 32> sha256(const uint8_t* data, size_t len) {
+    uint32_t state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    size_t full = len & ~size_t(63);
+    for (size_t i = 0; i < full; i += 64)
+        sha256Block(state, data + i);
+
+    // Final block(s): remaining bytes, 0x80, zero padding, 64-bit bit length
+    uint8_t last[128] = {};
+    size_t rem = len - full;
+    std::memcpy(last, data + full, rem);
+    last[rem] = 0x80;
+    size_t lastLen = (rem + 9 <= 64) ? 64 : 128;
+    uint64_t bits = static_cast<uint64_t>(len) * 8;
+    for (int i = 0; i < 8; ++i)
+        last[lastLen - 1 - i] = static_cast<uint8_t>(bits >> (i * 8));
+    for (size_t i = 0; i < lastLen; i += 64)
+        sha256Block(state, last + i);
+
+    std::array<uint8_t, 32> out;
+    for (int i = 0; i < 8; ++i) {
+        out[i * 4]     = static_cast<uint8_t>(state[i] >> 24);
+        out[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+        out[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+        out[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+    }
+    return out;
+}
+
+std::string hex_digest(const uint8_t* digest, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string s;
+    s.reserve(len * 2);
+    for (size_t i = 0; i < len; ++i) {
+        s += digits[digest[i] >> 4];
+        s += digits[digest[i] & 0xF];
+    }
+    return s;
+}
+
+std::string hex_digest(uint64_t value) {
+    uint8_t be[8];
+    for (int i = 0; i < 8; ++i)
+        be[i] = static_cast<uint8_t>(value >> (56 - i * 8));
+    return hex_digest(be, sizeof(be));
+}
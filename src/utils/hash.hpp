@@ -0,0 +1,30 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// XXH64, a fast non-cryptographic 64-bit hash (identical output to the
+// reference xxHash implementation).
+uint64_t xxhash64(const uint8_t* data, size_t len, uint64_t seed = 0);
+
+// Incremental XXH64 for data that arrives in pieces.
+class XXHash64 {
+public:
+    explicit XXHash64(uint64_t seed = 0);
+    void update(const uint8_t* data, size_t len);
+    uint64_t digest() const;
+
+private:
+    uint64_t v[4];
+    uint64_t seed;
+    uint64_t total = 0;
+    uint8_t tail[32];
+    size_t tailLen = 0;
+};
+
+// SHA-256 (FIPS 180-4)
+std::array<uint8_t, 32> sha256(const uint8_t* data, size_t len);
+
+std::string hex_digest(const uint8_t* digest, size_t len);
+std::string hex_digest(uint64_t value);
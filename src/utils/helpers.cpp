@@ -7,19 +7,19 @@
 //
 // Big-endian readers
 //
- uint16_t read_be16(const std::vector<uint8_t>& blob, size_t offset) {
+ uint16_t read_be16(const ByteView& blob, size_t offset) {
     return (blob[offset] << 8) |
            (blob[offset + 1]);
 }
 
- uint32_t read_be32(const std::vector<uint8_t>& blob, size_t offset) {
+ uint32_t read_be32(const ByteView& blob, size_t offset) {
     return (blob[offset] << 24) |
            (blob[offset + 1] << 16) |
            (blob[offset + 2] << 8) |
            (blob[offset + 3]);
 }
 
- uint64_t read_be64(const std::vector<uint8_t>& blob, size_t offset) {
+ uint64_t read_be64(const ByteView& blob, size_t offset) {
     return (static_cast<uint64_t>(blob[offset]) << 56) |
            (static_cast<uint64_t>(blob[offset + 1]) << 48) |
            (static_cast<uint64_t>(blob[offset + 2]) << 40) |
@@ -33,19 +33,19 @@
 //
 // Little-endian readers
 //
- uint16_t read_le16(const std::vector<uint8_t>& blob, size_t offset) {
+ uint16_t read_le16(const ByteView& blob, size_t offset) {
     return (blob[offset + 1] << 8) |
            (blob[offset]);
 }
 
- uint32_t read_le32(const std::vector<uint8_t>& blob, size_t offset) {
+ uint32_t read_le32(const ByteView& blob, size_t offset) {
     return (blob[offset + 3] << 24) |
            (blob[offset + 2] << 16) |
            (blob[offset + 1] << 8) |
            (blob[offset]);
 }
 
- uint64_t read_le64(const std::vector<uint8_t>& blob, size_t offset) {
+ uint64_t read_le64(const ByteView& blob, size_t offset) {
     return (static_cast<uint64_t>(blob[offset + 7]) << 56) |
            (static_cast<uint64_t>(blob[offset + 6]) << 48) |
            (static_cast<uint64_t>(blob[offset + 5]) << 40) |
@@ -59,7 +59,7 @@
 //
 // Null-terminated string reader
 //
- std::string read_string(const std::vector<uint8_t>& blob, size_t offset, size_t maxLength) {
+ std::string read_string(const ByteView& blob, size_t offset, size_t maxLength) {
     std::string result;
     for (size_t i = 0; i < maxLength && offset + i < blob.size(); ++i) {
         char c = static_cast<char>(blob[offset + i]);
@@ -89,20 +89,3 @@ std::string to_hex(int value)
    std::string hex(buffer.data(), result.ptr);
    return hex;
 }
-
-// CRC-16/ARC (polynomial 0xA001, initial value 0x0000)
-uint16_t crc16(const uint8_t* data, size_t len) {
-    uint16_t crc = 0x0000;
-
-    while (len--) {
-        crc ^= *data++;
-        for (int i = 0; i < 8; i++) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA001;
-            else
-                crc >>= 1;
-        }
-    }
-
-    return crc;
-}
@@ -1,4 +1,5 @@
 #pragma once
+#include "byte_view.hpp"
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -10,23 +11,21 @@
 //
 // Big-endian readers
 //
-uint16_t read_be16(const std::vector<uint8_t>& blob, size_t offset);
-uint32_t read_be32(const std::vector<uint8_t>& blob, size_t offset);
-uint64_t read_be64(const std::vector<uint8_t>& blob, size_t offset);
+uint16_t read_be16(const ByteView& blob, size_t offset);
+uint32_t read_be32(const ByteView& blob, size_t offset);
+uint64_t read_be64(const ByteView& blob, size_t offset);
 
 //
 // Little-endian readers
 //
- uint16_t read_le16(const std::vector<uint8_t>& blob, size_t offset);
- uint32_t read_le32(const std::vector<uint8_t>& blob, size_t offset);
- uint64_t read_le64(const std::vector<uint8_t>& blob, size_t offset);
+ uint16_t read_le16(const ByteView& blob, size_t offset);
+ uint32_t read_le32(const ByteView& blob, size_t offset);
+ uint64_t read_le64(const ByteView& blob, size_t offset);
 
 //
 // Null-terminated string reader
 //
- std::string read_string(const std::vector<uint8_t>& blob, size_t offset, size_t maxLength);
+ std::string read_string(const ByteView& blob, size_t offset, size_t maxLength);
 
  std::string format_timestamp(uint32_t ts);
 std::string to_hex(int value);
-
-uint16_t crc16(const uint8_t* data, size_t len);
\ No newline at end of file
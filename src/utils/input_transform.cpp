@@ -0,0 +1,279 @@
+#include "input_transform.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+uint16_t le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+constexpr size_t SPARSE_HEADER_SIZE = 28;
+constexpr size_t SPARSE_CHUNK_HEADER_SIZE = 12;
+constexpr uint32_t DEFAULT_NAND_PAGE = 2048;
+constexpr uint32_t DEFAULT_NAND_OOB = 64;
+
+} // namespace
+
+//
+// Android sparse image
+//
+AndroidSparseInput::AndroidSparseInput(std::unique_ptr<InputSource> source)
+    : source(std::move(source)) {}
+
+bool AndroidSparseInput::readExact(uint8_t* dst, size_t count) {
+    return source->read(dst, count) == count;
+}
+
+bool AndroidSparseInput::open() {
+    uint8_t h[SPARSE_HEADER_SIZE];
+    if (!readExact(h, sizeof(h)) || le32(h) != ANDROID_SPARSE_MAGIC)
+        return false;
+    uint16_t major = le16(h + 4);
+    uint16_t fileHeaderSize = le16(h + 8);
+    chunkHeaderSize = le16(h + 10);
+    blockSize = le32(h + 12);
+    uint32_t totalBlocks = le32(h + 16);
+    chunksLeft = le32(h + 20);
+    if (major != 1 || fileHeaderSize < SPARSE_HEADER_SIZE ||
+        chunkHeaderSize < SPARSE_CHUNK_HEADER_SIZE || blockSize == 0 || blockSize % 4) {
+        Logger::error("Unsupported Android sparse image header");
+        return false;
+    }
+    source->skip(fileHeaderSize - SPARSE_HEADER_SIZE);
+    expandedSize = static_cast<uint64_t>(totalBlocks) * blockSize;
+    return true;
+}
+
+bool AndroidSparseInput::nextChunk() {
+    while (chunksLeft > 0) {
+        uint64_t headerOffset = source->position();
+        uint8_t h[SPARSE_CHUNK_HEADER_SIZE];
+        if (!readExact(h, sizeof(h)))
+            break;
+        source->skip(chunkHeaderSize - SPARSE_CHUNK_HEADER_SIZE);
+        --chunksLeft;
+
+        uint16_t chunkType = le16(h);
+        uint64_t expanded = static_cast<uint64_t>(le32(h + 4)) * blockSize;
+        uint32_t totalSize = le32(h + 8);
+        // A chunk of no blocks expands to nothing, it does not end the image
+        switch (chunkType) {
+        case CHUNK_RAW:
+            if (totalSize != chunkHeaderSize + expanded)
+                break;
+            if (expanded == 0)
+                continue;
+            chunks.push_back({pos, source->position(), chunkType});
+            type = chunkType;
+            remaining = expanded;
+            return true;
+        case CHUNK_FILL: {
+            uint8_t v[4];
+            if (totalSize != chunkHeaderSize + 4u || !readExact(v, sizeof(v)))
+                break;
+            if (expanded == 0)
+                continue;
+            chunks.push_back({pos, headerOffset, chunkType});
+            type = chunkType;
+            fill = le32(v);
+            remaining = expanded;
+            return true;
+        }
+        case CHUNK_DONT_CARE:
+            if (totalSize != chunkHeaderSize)
+                break;
+            if (expanded == 0)
+                continue;
+            chunks.push_back({pos, headerOffset, chunkType});
+            type = chunkType;
+            remaining = expanded;
+            return true;
+        case CHUNK_CRC32:
+            // The CRC of the data so far, not checked
+            if (totalSize != chunkHeaderSize + 4u)
+                break;
+            source->skip(4);
+            continue;
+        default:
+            break;
+        }
+        std::ostringstream where;
+        where << std::hex << headerOffset;
+        Logger::error("Malformed Android sparse chunk at 0x" + where.str());
+        break;
+    }
+    chunksLeft = 0;
+    remaining = 0;
+    return false;
+}
+
+size_t AndroidSparseInput::read(uint8_t* dst, size_t count) {
+    size_t done = 0;
+    while (done < count) {
+        if (remaining == 0 && !nextChunk())
+            break;
+        size_t n = static_cast<size_t>(std::min<uint64_t>(count - done, remaining));
+        if (type == CHUNK_RAW) {
+            size_t got = source->read(dst + done, n);
+            if (got < n) {
+                done += got;
+                pos += got;
+                remaining = 0;
+                chunksLeft = 0;
+                break;
+            }
+        } else if (type == CHUNK_FILL) {
+            // The pattern phase follows the expanded offset, blocks are
+            // multiples of 4 bytes
+            for (size_t i = 0; i < n; ++i)
+                dst[done + i] = static_cast<uint8_t>(fill >> (8 * ((pos + i) & 3)));
+        } else {
+            std::memset(dst + done, 0, n);
+        }
+        done += n;
+        pos += n;
+        remaining -= n;
+    }
+    return done;
+}
+
+void AndroidSparseInput::skip(uint64_t count) {
+    while (count > 0) {
+        if (remaining == 0 && !nextChunk())
+            break;
+        uint64_t n = std::min(count, remaining);
+        if (type == CHUNK_RAW)
+            source->skip(n);
+        pos += n;
+        remaining -= n;
+        count -= n;
+    }
+}
+
+uint64_t AndroidSparseInput::holeLength() {
+    if (remaining == 0 && !nextChunk())
+        return 0;
+    return isHole() ? remaining : 0;
+}
+
+uint64_t AndroidSparseInput::dataLength() {
+    if (remaining == 0 && !nextChunk())
+        return UINT64_MAX;
+    return isHole() ? 0 : remaining;
+}
+
+uint64_t AndroidSparseInput::physicalOffset(uint64_t logical) const {
+    auto it = std::upper_bound(chunks.begin(), chunks.end(), logical,
+                               [](uint64_t v, const Chunk& c) { return v < c.logical; });
+    if (it == chunks.begin())
+        return 0;
+    --it;
+    return it->type == CHUNK_RAW ? it->physical + (logical - it->logical) : it->physical;
+}
+
+//
+// NAND with interleaved OOB
+//
+NandOobInput::NandOobInput(std::unique_ptr<InputSource> source, uint32_t pageSize, uint32_t oobSize)
+    : source(std::move(source)), pageSize(pageSize), oobSize(oobSize) {}
+
+uint64_t NandOobInput::physicalOffset(uint64_t logical) const {
+    return (logical / pageSize) * (pageSize + oobSize) + logical % pageSize;
+}
+
+uint64_t NandOobInput::size() const {
+    uint64_t raw = source->size();
+    uint64_t stride = pageSize + oobSize;
+    return raw / stride * pageSize + std::min<uint64_t>(raw % stride, pageSize);
+}
+
+void NandOobInput::seekSource(uint64_t logical) {
+    uint64_t target = physicalOffset(logical);
+    if (target > source->position())
+        source->skip(target - source->position());
+}
+
+size_t NandOobInput::read(uint8_t* dst, size_t count) {
+    size_t done = 0;
+    while (done < count) {
+        seekSource(pos);
+        size_t n = static_cast<size_t>(std::min<uint64_t>(count - done, pageSize - pos % pageSize));
+        size_t got = source->read(dst + done, n);
+        done += got;
+        pos += got;
+        if (got < n)
+            break;
+    }
+    return done;
+}
+
+void NandOobInput::skip(uint64_t count) {
+    pos += count;
+    seekSource(pos);
+}
+
+//
+// Factory
+//
+bool isAndroidSparseImage(const std::string& path) {
+    std::error_code ec;
+    if (path == "-" || !std::filesystem::is_regular_file(path, ec))
+        return false;
+    std::ifstream f(path, std::ios::binary);
+    uint8_t m[4] = {};
+    return f.read(reinterpret_cast<char*>(m), sizeof(m)) && le32(m) == ANDROID_SPARSE_MAGIC;
+}
+
+std::unique_ptr<InputSource> openInput(const std::string& path, const std::string& transform) {
+    std::string kind = transform.substr(0, transform.find(':'));
+    if (kind.empty() && isAndroidSparseImage(path)) {
+        Logger::info("Android sparse image detected, scanning the expanded image");
+        kind = "android-sparse";
+    }
+
+    auto raw = std::make_unique<StreamInput>();
+    if (!raw->open(path)) {
+        Logger::error("Error: Cannot open file " + path);
+        return nullptr;
+    }
+    if (kind.empty() || kind == "raw")
+        return raw;
+
+    if (kind == "android-sparse") {
+        auto sparse = std::make_unique<AndroidSparseInput>(std::move(raw));
+        if (!sparse->open()) {
+            Logger::error("Not an Android sparse image: " + path);
+            return nullptr;
+        }
+        return sparse;
+    }
+
+    if (kind == "nand") {
+        uint32_t page = DEFAULT_NAND_PAGE;
+        uint32_t oob = DEFAULT_NAND_OOB;
+        size_t colon = transform.find(':');
+        if (colon != std::string::npos) {
+            unsigned long p = 0, o = 0;
+            if (std::sscanf(transform.c_str() + colon + 1, "%lu:%lu", &p, &o) != 2 || p == 0) {
+                Logger::error("Invalid NAND geometry " + transform.substr(colon + 1) + ", expected PAGE:OOB");
+                return nullptr;
+            }
+            page = static_cast<uint32_t>(p);
+            oob = static_cast<uint32_t>(o);
+        }
+        return std::make_unique<NandOobInput>(std::move(raw), page, oob);
+    }
+
+    Logger::error("Unknown input transform " + transform);
+    return nullptr;
+}
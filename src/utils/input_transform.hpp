@@ -0,0 +1,94 @@
+#pragma once
+#include "stream_input.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+constexpr uint32_t ANDROID_SPARSE_MAGIC = 0xED26FF3A;
+
+// Expands an Android sparse image (simg) on the fly. RAW chunks are read
+// through, FILL chunks are generated from their 4-byte pattern and
+// DONT_CARE chunks (and zero fills) are reported as holes, so nothing is
+// materialised and the scanner can jump over them.
+class AndroidSparseInput : public InputSource {
+public:
+    explicit AndroidSparseInput(std::unique_ptr<InputSource> source);
+
+    // Reads and checks the file header, false if this is not a sparse image
+    bool open();
+
+    size_t read(uint8_t* dst, size_t count) override;
+    void skip(uint64_t count) override;
+    uint64_t holeLength() override;
+    uint64_t dataLength() override;
+    uint64_t position() const override { return pos; }
+    uint64_t size() const override { return expandedSize; }
+    bool remapped() const override { return true; }
+    // RAW chunks map to their data in the image, the other chunk types to
+    // their chunk header
+    uint64_t physicalOffset(uint64_t logical) const override;
+
+private:
+    enum ChunkType : uint16_t {
+        CHUNK_RAW       = 0xCAC1,
+        CHUNK_FILL      = 0xCAC2,
+        CHUNK_DONT_CARE = 0xCAC3,
+        CHUNK_CRC32     = 0xCAC4,
+    };
+    struct Chunk {
+        uint64_t logical;   // first expanded byte
+        uint64_t physical;  // data (RAW) or chunk header in the image
+        uint16_t type;
+    };
+
+    bool readExact(uint8_t* dst, size_t count);
+    bool nextChunk();       // loads the next data-bearing chunk, false at the end
+    bool isHole() const { return type == CHUNK_DONT_CARE || (type == CHUNK_FILL && fill == 0); }
+
+    std::unique_ptr<InputSource> source;
+    uint32_t blockSize = 0;
+    uint32_t chunksLeft = 0;
+    uint16_t chunkHeaderSize = 0;
+    uint64_t expandedSize = 0;
+    uint64_t pos = 0;
+    uint16_t type = 0;        // current chunk
+    uint64_t remaining = 0;   // expanded bytes left in the current chunk
+    uint32_t fill = 0;
+    std::vector<Chunk> chunks;
+};
+
+// Presents a raw NAND dump without its spare areas: every page of
+// `pageSize` data bytes is followed by `oobSize` bytes of OOB, which are
+// dropped so that structures spanning pages are contiguous again.
+class NandOobInput : public InputSource {
+public:
+    NandOobInput(std::unique_ptr<InputSource> source, uint32_t pageSize, uint32_t oobSize);
+
+    size_t read(uint8_t* dst, size_t count) override;
+    void skip(uint64_t count) override;
+    uint64_t position() const override { return pos; }
+    uint64_t size() const override;
+    bool remapped() const override { return true; }
+    uint64_t physicalOffset(uint64_t logical) const override;
+
+private:
+    void seekSource(uint64_t logical);
+
+    std::unique_ptr<InputSource> source;
+    uint32_t pageSize;
+    uint32_t oobSize;
+    uint64_t pos = 0;
+};
+
+// Whether a regular file starts with the Android sparse image magic
+bool isAndroidSparseImage(const std::string& path);
+
+// Opens `path` ("-" for stdin) for a streaming scan, behind the transformer
+// named by `transform`:
+//   ""                       raw input, Android sparse images are detected
+//   "raw"                    raw input, no detection
+//   "android-sparse"         AndroidSparseInput
+//   "nand[:PAGE:OOB]"        NandOobInput, default geometry 2048:64
+// Returns nullptr and logs on errors.
+std::unique_ptr<InputSource> openInput(const std::string& path, const std::string& transform);
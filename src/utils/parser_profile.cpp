@@ -0,0 +1,100 @@
+#include "parser_profile.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+static const char* const PROFILE_HEADER = "# hexdig parser stats 1";
+
+void ParserCounters::add(const ParserCounters& other) {
+    probes += other.probes;
+    hits += other.hits;
+    timed += other.timed;
+    nanos += other.nanos;
+}
+
+bool ParserProfile::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in)
+        return true;
+    std::string line;
+    if (!std::getline(in, line) || line != PROFILE_HEADER) {
+        Logger::error("Ignoring parser stats in " + path + ", unknown format");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    while (std::getline(in, line)) {
+        // name \t probes \t hits \t timed \t nanos
+        std::istringstream fields(line);
+        std::string name;
+        ParserCounters c;
+        if (!std::getline(fields, name, '\t') || !(fields >> c.probes >> c.hits >> c.timed >> c.nanos))
+            continue;
+        counters[name].add(c);
+    }
+    return true;
+}
+
+bool ParserProfile::save(const std::string& path) const {
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out) {
+            Logger::error("Cannot write parser stats to " + path);
+            return false;
+        }
+        out << PROFILE_HEADER << '\n';
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& [name, c] : counters)
+            out << name << '\t' << c.probes << '\t' << c.hits << '\t' << c.timed << '\t' << c.nanos << '\n';
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        Logger::error("Cannot write parser stats to " + path + ": " + ec.message());
+        return false;
+    }
+    return true;
+}
+
+void ParserProfile::add(const std::string& name, const ParserCounters& c) {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters[name].add(c);
+}
+
+ParserCounters ParserProfile::get(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = counters.find(name);
+    return it != counters.end() ? it->second : ParserCounters();
+}
+
+bool ParserProfile::empty() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters.empty();
+}
+
+std::string ParserProfile::report() const {
+    std::vector<std::pair<std::string, ParserCounters>> rows;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        rows.assign(counters.begin(), counters.end());
+    }
+    auto total = [](const ParserCounters& c) { return c.nanosPerProbe() * c.probes; };
+    std::stable_sort(rows.begin(), rows.end(),
+                     [&](const auto& a, const auto& b) { return total(a.second) > total(b.second); });
+
+    std::string out;
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-14s %14s %10s %10s %12s\n", "PARSER", "PROBES", "HITS", "NS/PROBE", "TOTAL MS");
+    out += line;
+    for (const auto& [name, c] : rows) {
+        std::snprintf(line, sizeof(line), "%-14s %14llu %10llu %10.1f %12.1f\n", name.c_str(),
+                      (unsigned long long)c.probes, (unsigned long long)c.hits,
+                      c.nanosPerProbe(), total(c) / 1e6);
+        out += line;
+    }
+    return out;
+}
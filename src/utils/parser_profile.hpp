@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Probe counters of one parser. Every probe is counted, only a sample of
+// them is timed.
+struct ParserCounters {
+    uint64_t probes = 0;   // probe() calls
+    uint64_t hits = 0;     // valid results
+    uint64_t timed = 0;    // probes that were timed
+    uint64_t nanos = 0;    // time spent in the timed probes
+
+    double nanosPerProbe() const { return timed ? static_cast<double>(nanos) / timed : 0.0; }
+    void add(const ParserCounters& other);
+};
+
+// Probe statistics by parser name, summed over scans (--profile) and
+// optionally kept in a file between runs (--parser-stats). Scanners order
+// the probes of an offset by them, see Scanner::orderProbes. Thread-safe.
+class ParserProfile {
+public:
+    // Adds the counters stored in `path`; a missing file is an empty profile
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    void add(const std::string& name, const ParserCounters& counters);
+    ParserCounters get(const std::string& name) const;
+    bool empty() const;
+
+    // One line per parser, the most expensive in total first
+    std::string report() const;
+
+private:
+    mutable std::mutex mutex;
+    std::map<std::string, ParserCounters> counters;
+};
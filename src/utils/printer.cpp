@@ -5,10 +5,18 @@
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <cstring>
 #include <fstream>
 #include <vector>
 #include <filesystem>
+#include <cstdio>
+#include <cctype>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace fs = std::filesystem;
 
@@ -26,17 +34,31 @@ namespace ansi {
 
 
 
-cJSON* build_json_result(const ScanResult& r) {
+cJSON* build_json_result(const ResultView& r) {
     cJSON* item = cJSON_CreateObject();
-    cJSON_AddNumberToObject(item, "offset", static_cast<double>(r.offset));
-    cJSON_AddStringToObject(item, "type", r.type.c_str());
-    cJSON_AddNumberToObject(item, "size", static_cast<double>(r.length));
-    cJSON_AddStringToObject(item, "source", r.source.c_str());
-    cJSON_AddStringToObject(item, "info", r.info.c_str());
+    cJSON_AddNumberToObject(item, "offset", static_cast<double>(r.offset()));
+    cJSON_AddStringToObject(item, "type", std::string(r.type()).c_str());
+    cJSON_AddNumberToObject(item, "size", static_cast<double>(r.length()));
+    cJSON_AddStringToObject(item, "source", std::string(r.source()).c_str());
+    cJSON_AddStringToObject(item, "info", r.info().c_str());
+    if (r.fieldCount()) {
+        cJSON* fields = cJSON_CreateObject();
+        for (const InfoField& f : r.fields()) {
+            if (f.format == InfoField::TEXT)
+                cJSON_AddStringToObject(fields, f.key, f.text.c_str());
+            else if (f.format == InfoField::SIGNED)
+                cJSON_AddNumberToObject(fields, f.key, static_cast<double>(static_cast<int64_t>(f.number)));
+            else
+                cJSON_AddNumberToObject(fields, f.key, static_cast<double>(f.number));
+        }
+        cJSON_AddItemToObject(item, "fields", fields);
+    }
+    if (r.budgetExceeded())
+        cJSON_AddBoolToObject(item, "budget_exceeded", 1);
 
-    if (!r.children.empty()) {
+    if (r.hasChildren()) {
         cJSON* childArray = cJSON_CreateArray();
-        for (const auto& child : r.children) {
+        for (ResultView child : r.children()) {
             cJSON_AddItemToArray(childArray, build_json_result(child));
         }
         cJSON_AddItemToObject(item, "children", childArray);
@@ -45,12 +67,12 @@ cJSON* build_json_result(const ScanResult& r) {
     return item;
 }
 
-void dumpJson(const std::vector<ScanResult>& results,std::string filename) {
+void dumpJson(const ResultStore& results,std::string filename) {
     fs::path outputPath = fs::path(filename);
     std::ofstream outFile(outputPath, std::ios::binary);
     if (outFile.is_open()) {
         cJSON* root = cJSON_CreateArray();
-        for (const auto& r : results) {
+        for (ResultView r : results.topLevel()) {
             cJSON_AddItemToArray(root, build_json_result(r));
         }
 
@@ -66,6 +88,35 @@ void dumpJson(const std::vector<ScanResult>& results,std::string filename) {
     
 }
 
+std::string jsonLine(const ResultView& result) {
+    cJSON* item = build_json_result(result);
+    char* jsonStr = cJSON_PrintUnformatted(item);
+    std::string line(jsonStr);
+    cJSON_Delete(item);
+    free(jsonStr);
+    return line;
+}
+
+void dumpJsonBatch(const std::vector<std::pair<std::string, ResultStore>>& inputs, std::string filename) {
+    std::ofstream outFile(fs::path(filename), std::ios::binary);
+    if (!outFile.is_open())
+        return;
+    cJSON* root = cJSON_CreateArray();
+    for (const auto& input : inputs) {
+        cJSON* item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "file", input.first.c_str());
+        cJSON* results = cJSON_CreateArray();
+        for (ResultView r : input.second.topLevel())
+            cJSON_AddItemToArray(results, build_json_result(r));
+        cJSON_AddItemToObject(item, "results", results);
+        cJSON_AddItemToArray(root, item);
+    }
+    char* jsonStr = cJSON_Print(root);
+    outFile.write(jsonStr, strlen(jsonStr));
+    cJSON_Delete(root);
+    free(jsonStr);
+}
+
 void printResult(const ScanResult& result, int depth) {
     std::cout << "+-";
     for (int i=0;i<depth;i++) std::cout<<"-";
@@ -73,7 +124,7 @@ void printResult(const ScanResult& result, int depth) {
     std::cout << "0x" << std::hex << result.offset
               << "\t\t[" << result.type<<"]"
               << "\t\t" << std::dec << result.length;
-    std::cout << "\t\t" << result.info.substr(0,16)<< (result.extracted?"(extracted)":"")<< "\n";
+    std::cout << "\t\t" << result.info.str().substr(0,16)<< (result.extracted?"(extracted)":"")<< "\n";
 
    /* for (const auto& child : result.children) {
         printResult(child, depth + 1);
@@ -82,61 +133,160 @@ void printResult(const ScanResult& result, int depth) {
 
 
 
-// Wrap long text into multiple lines with indentation
-static std::vector<std::string> wrapText(const std::string& text, size_t width) {
+// Wrap long text into lines of at most `width` characters, splitting on
+// whitespace without going through a stringstream.
+static std::vector<std::string> wrapText(std::string_view text, size_t width) {
     std::vector<std::string> lines;
-    std::istringstream words(text);
-    std::string word, line;
-    while (words >> word) {
-        if (line.size() + word.size() + 1 > width) {
+    std::string line;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))) ++i;
+        size_t start = i;
+        while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i]))) ++i;
+        if (start == i) break;
+
+        size_t wordLen = i - start;
+        if (line.size() + wordLen + 1 > width) {
             lines.push_back(line);
             line.clear();
         }
-        if (!line.empty()) line += " ";
-        line += word;
+        if (!line.empty()) line += ' ';
+        line.append(text, start, wordLen);
     }
     if (!line.empty()) lines.push_back(line);
     return lines;
 }
 
-static void printScanResult(const ScanResult& sr, const std::string& prefix = "", bool last = true) {
-    // Offset in cyan, type in bold yellow, length in green
-    std::ostringstream oss;
-    oss << ansi::cyan << "[0x" << std::hex << std::setw(4) << std::setfill('0') << sr.offset << "]" << ansi::reset
-        << " " << ansi::bold << ansi::yellow << sr.type << ansi::reset
-        << " (length=" << ansi::green << std::dec << sr.length << ansi::reset << ")" << (sr.extracted?"(extracted)":"");
+static bool stdoutIsTerminal() {
+#ifdef _WIN32
+    return _isatty(_fileno(stdout)) != 0;
+#else
+    return isatty(fileno(stdout)) != 0;
+#endif
+}
+
+TreePrinter::TreePrinter() : TreePrinter(stdoutIsTerminal()) {}
+
+TreePrinter::TreePrinter(std::string* capture) : TreePrinter(stdoutIsTerminal()) {
+    this->capture = capture;
+}
+
+TreePrinter::TreePrinter(bool color) : color(color) {
+    buffer.reserve(FLUSH_THRESHOLD * 2);
+}
+
+TreePrinter::~TreePrinter() {
+    flush();
+}
+
+void TreePrinter::beginScan(const std::string& inputFile) {
+    hasResults = false;
+    append(ansi::reset);
+    buffer += "* ";
+    buffer += inputFile;
+    buffer += '\n';
+    flush();
+}
+
+void TreePrinter::onResult(const ResultView& result) {
+    // Whether another result follows is not known yet, the end marker
+    // drawn by endScan() is the last sibling instead
+    printNode(result, "", false);
+    hasResults = true;
+    flush();
+}
+
+void TreePrinter::endScan() {
+    if (hasResults) {
+        buffer += "└── ";
+        append(ansi::gray);
+        buffer += "end";
+        append(ansi::reset);
+        buffer += '\n';
+    }
+    flush();
+}
 
-    std::cout << prefix << (last ? "└── " : "├── ") << oss.str() << "\n";
+void TreePrinter::append(const std::string& code) {
+    if (color) buffer += code;
+}
+
+void TreePrinter::flush() {
+    if (buffer.empty()) return;
+    if (capture) {
+        *capture += buffer;
+        buffer.clear();
+        return;
+    }
+    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+    std::fflush(stdout);
+    buffer.clear();
+}
+
+void TreePrinter::printNode(const ResultView& sr, const std::string& prefix, bool last) {
+    char num[32];
+
+    // Offset in cyan, type in bold yellow, length in green
+    buffer += prefix;
+    buffer += last ? "└── " : "├── ";
+    append(ansi::cyan);
+    std::snprintf(num, sizeof(num), "[0x%04llx]", (unsigned long long)sr.offset());
+    buffer += num;
+    append(ansi::reset);
+    buffer += ' ';
+    append(ansi::bold);
+    append(ansi::yellow);
+    buffer += sr.type();
+    append(ansi::reset);
+    buffer += " (length=";
+    append(ansi::green);
+    buffer += std::to_string(sr.length());
+    append(ansi::reset);
+    buffer += ')';
+    if (sr.extracted()) buffer += "(extracted)";
+    buffer += '\n';
 
     // Prepare child prefix
     std::string childPrefix = prefix + (last ? "    " : "│   ");
 
     // Source in magenta
-    if (!sr.source.empty()) {
-        std::cout << childPrefix << ansi::magenta << "Source: " << sr.source << ansi::reset << "\n";
+    if (!sr.source().empty()) {
+        buffer += childPrefix;
+        append(ansi::magenta);
+        buffer += "Source: ";
+        buffer += sr.source();
+        append(ansi::reset);
+        buffer += '\n';
     }
 
     // Info wrapped, in gray
-    if (!sr.info.empty()) {
-        auto lines = wrapText(sr.info, 60);
-        if (!lines.empty()) {
-            std::cout << childPrefix << ansi::gray << "Info: " << lines[0] << ansi::reset << "\n";
-            for (size_t i = 1; i < lines.size(); ++i) {
-                std::cout << childPrefix << ansi::gray << "      " << lines[i] << ansi::reset << "\n";
-            }
+    std::string info = sr.info();
+    if (!info.empty()) {
+        auto lines = wrapText(info, 60);
+        for (size_t i = 0; i < lines.size(); ++i) {
+            buffer += childPrefix;
+            append(ansi::gray);
+            buffer += (i == 0) ? "Info: " : "      ";
+            buffer += lines[i];
+            append(ansi::reset);
+            buffer += '\n';
         }
     }
 
+    if (buffer.size() >= FLUSH_THRESHOLD) flush();
+
     // Children recursively
-    for (size_t i = 0; i < sr.children.size(); ++i) {
-        printScanResult(sr.children[i], childPrefix, i == sr.children.size() - 1);
+    for (ResultView child : sr.children()) {
+        printNode(child, childPrefix, child.isLastSibling());
     }
 }
 
-// Entry point: print a vector of ScanResult
-void printScanResults(const std::vector<ScanResult>& results,std::string inputFile) {
-    std::cout<< ansi::reset <<"* "<<inputFile<<std::endl;
-    for (size_t i = 0; i < results.size(); ++i) {
-        printScanResult(results[i], "", i == results.size() - 1);
+// Entry point: print the results of a ResultStore
+void printScanResults(const ResultStore& results,std::string inputFile) {
+    TreePrinter printer;
+    printer.beginScan(inputFile);
+    for (ResultView r : results.topLevel()) {
+        printer.onResult(r);
     }
+    printer.endScan();
 }
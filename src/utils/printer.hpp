@@ -1,6 +1,45 @@
 #pragma once
 #include "scanresult.hpp"
+#include "result_store.hpp"
+#include "result_sink.hpp"
+#include <string>
+#include <utility>
+#include <vector>
+
 void printResult(const ScanResult& result, int depth = 0);
-void dumpJson(const std::vector<ScanResult>& results,std::string filename);
-void printTree(const ScanResult& node, const std::string& prefix = "", bool isLast = true);
-void printScanResults(const std::vector<ScanResult>& results,std::string inputFile);
\ No newline at end of file
+void dumpJson(const ResultStore& results,std::string filename);
+void printScanResults(const ResultStore& results,std::string inputFile);
+// One result (with its children) as single-line JSON, for NDJSON output
+std::string jsonLine(const ResultView& result);
+// Batch scans: one {"file", "results"} object per input
+void dumpJsonBatch(const std::vector<std::pair<std::string, ResultStore>>& inputs, std::string filename);
+
+// Draws the result tree incrementally while the scan runs. Each top-level
+// result is drawn as soon as it arrives, as a sibling, and endScan() closes
+// the tree with an end marker. Output is accumulated in one buffer and
+// written with a single fwrite per top-level result; colour codes are only emitted when stdout is a terminal. With a
+// capture string the output is collected there instead, so that parallel
+// scans can be printed one input at a time.
+class TreePrinter : public ResultSink {
+public:
+    TreePrinter();
+    explicit TreePrinter(bool color);
+    explicit TreePrinter(std::string* capture);
+    ~TreePrinter() override;
+
+    void beginScan(const std::string& inputFile) override;
+    void onResult(const ResultView& result) override;
+    void endScan() override;
+
+private:
+    static constexpr size_t FLUSH_THRESHOLD = 1 << 16;
+
+    void printNode(const ResultView& sr, const std::string& prefix, bool last);
+    void append(const std::string& code);
+    void flush();
+
+    bool color;
+    std::string* capture = nullptr;
+    bool hasResults = false;  // since beginScan()
+    std::string buffer;
+};
@@ -0,0 +1,298 @@
+#include "scan_index.hpp"
+#include "logger.hpp"
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <utility>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+class IndexBuilder {
+public:
+    IndexBuilder() { strings.push_back('\0'); }
+
+    uint32_t intern(std::string_view s) {
+        if (s.empty()) return 0;
+        std::string key(s);
+        auto it = stringOffsets.find(key);
+        if (it != stringOffsets.end()) return it->second;
+        uint32_t off = static_cast<uint32_t>(strings.size());
+        strings.insert(strings.end(), s.begin(), s.end());
+        strings.push_back('\0');
+        stringOffsets.emplace(std::move(key), off);
+        return off;
+    }
+
+    uint32_t nameId(std::string_view s) {
+        std::string key(s);
+        auto it = nameIds.find(key);
+        if (it != nameIds.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(names.size());
+        names.push_back(intern(s));
+        nameIds.emplace(std::move(key), id);
+        return id;
+    }
+
+    void add(const ResultView& r, uint32_t parent) {
+        uint32_t index = static_cast<uint32_t>(records.size());
+        HdxRecord rec{};
+        rec.offset = r.offset();
+        rec.length = r.length();
+        rec.typeId = nameId(r.type());
+        rec.extractorId = r.extractorType().empty() ? HDX_NONE : nameId(r.extractorType());
+        rec.parent = parent;
+        rec.flags = (r.isValid() ? uint32_t(HDX_FLAG_VALID) : 0u) |
+                    (r.confident() ? uint32_t(HDX_FLAG_CONFIDENT) : 0u) |
+                    (r.extracted() ? uint32_t(HDX_FLAG_EXTRACTED) : 0u) |
+                    (r.budgetExceeded() ? uint32_t(HDX_FLAG_BUDGET_EXCEEDED) : 0u);
+        rec.info = intern(r.info());
+        rec.source = intern(r.source());
+        records.push_back(rec);
+        for (const InfoField& f : r.fields()) {
+            HdxField field{};
+            field.record = index;
+            field.key = intern(f.key);
+            field.number = f.number;
+            field.text = intern(f.text);
+            field.format = f.format;
+            fields.push_back(field);
+        }
+
+        uint32_t children = 0;
+        for (ResultView child : r.children()) {
+            add(child, index);
+            ++children;
+        }
+        records[index].childCount = children;
+    }
+
+    std::vector<HdxRecord> records;
+    std::vector<HdxField> fields;
+    std::vector<uint32_t> names;
+    std::vector<char> strings;
+
+private:
+    std::unordered_map<std::string, uint32_t> stringOffsets;
+    std::unordered_map<std::string, uint32_t> nameIds;
+};
+
+uint64_t align8(uint64_t v) {
+    return (v + 7) & ~uint64_t(7);
+}
+
+void writePadding(std::ofstream& out, uint64_t from, uint64_t to) {
+    static const char zeros[8] = {};
+    out.write(zeros, static_cast<std::streamsize>(to - from));
+}
+
+} // namespace
+
+bool writeScanIndex(const ResultStore& results, const ScanIndexMeta& meta,
+                    const std::filesystem::path& outPath) {
+    IndexBuilder b;
+    uint32_t inputName = b.intern(meta.inputName);
+    for (ResultView r : results.topLevel())
+        b.add(r, HDX_NONE);
+
+    HdxHeader h{};
+    std::memcpy(h.magic, HDX_MAGIC, sizeof(h.magic));
+    h.version = HDX_VERSION;
+    h.headerSize = sizeof(HdxHeader);
+    h.recordSize = sizeof(HdxRecord);
+    h.nameCount = static_cast<uint32_t>(b.names.size());
+    h.recordCount = b.records.size();
+    h.recordsOffset = sizeof(HdxHeader);
+    h.namesOffset = align8(h.recordsOffset + h.recordCount * sizeof(HdxRecord));
+    h.stringsOffset = align8(h.namesOffset + h.nameCount * sizeof(uint32_t));
+    h.stringsSize = b.strings.size();
+    if (!b.fields.empty()) {
+        h.fieldsOffset = align8(h.stringsOffset + h.stringsSize);
+        h.fieldCount = b.fields.size();
+    }
+    h.inputSize = meta.inputSize;
+    h.inputHash = meta.inputHash;
+    h.inputName = inputName;
+    h.parserSet = meta.parserSet;
+
+    std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        Logger::error("Cannot write scan index " + outPath.string());
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(b.records.data()),
+              static_cast<std::streamsize>(b.records.size() * sizeof(HdxRecord)));
+    writePadding(out, h.recordsOffset + h.recordCount * sizeof(HdxRecord), h.namesOffset);
+    out.write(reinterpret_cast<const char*>(b.names.data()),
+              static_cast<std::streamsize>(b.names.size() * sizeof(uint32_t)));
+    writePadding(out, h.namesOffset + h.nameCount * sizeof(uint32_t), h.stringsOffset);
+    out.write(b.strings.data(), static_cast<std::streamsize>(b.strings.size()));
+    if (h.fieldCount) {
+        writePadding(out, h.stringsOffset + h.stringsSize, h.fieldsOffset);
+        out.write(reinterpret_cast<const char*>(b.fields.data()),
+                  static_cast<std::streamsize>(b.fields.size() * sizeof(HdxField)));
+    }
+    return static_cast<bool>(out);
+}
+
+ScanIndexReader::~ScanIndexReader() {
+    close();
+}
+
+void ScanIndexReader::close() {
+#ifndef _WIN32
+    if (mapped && data)
+        munmap(const_cast<uint8_t*>(data), length);
+#endif
+    data = nullptr;
+    length = 0;
+    mapped = false;
+    buffer.clear();
+}
+
+bool ScanIndexReader::open(const std::filesystem::path& path) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        Logger::error("Cannot open scan index " + path.string());
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            data = static_cast<const uint8_t*>(p);
+            length = static_cast<size_t>(st.st_size);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+#endif
+    if (!data) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            Logger::error("Cannot open scan index " + path.string());
+            return false;
+        }
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        length = buffer.size();
+    }
+
+    // Validate the header and that every section lies inside the file
+    const HdxHeader* h = reinterpret_cast<const HdxHeader*>(data);
+    bool ok = length >= sizeof(HdxHeader) &&
+              std::memcmp(h->magic, HDX_MAGIC, sizeof(h->magic)) == 0 &&
+              h->version == HDX_VERSION &&
+              h->headerSize >= sizeof(HdxHeader) &&
+              h->recordSize >= sizeof(HdxRecord) &&
+              h->recordsOffset <= length &&
+              h->recordCount <= (length - h->recordsOffset) / h->recordSize &&
+              h->namesOffset <= length &&
+              h->nameCount <= (length - h->namesOffset) / sizeof(uint32_t) &&
+              h->stringsOffset <= length &&
+              h->stringsSize <= length - h->stringsOffset &&
+              h->stringsSize > 0 &&
+              data[h->stringsOffset + h->stringsSize - 1] == '\0' &&
+              h->fieldsOffset <= length &&
+              h->fieldCount <= (length - h->fieldsOffset) / sizeof(HdxField);
+    if (!ok) {
+        Logger::error("Invalid or unsupported scan index " + path.string());
+        close();
+        return false;
+    }
+    return true;
+}
+
+const HdxRecord& ScanIndexReader::record(size_t i) const {
+    const HdxHeader& h = header();
+    return *reinterpret_cast<const HdxRecord*>(data + h.recordsOffset + i * h.recordSize);
+}
+
+const char* ScanIndexReader::string(uint32_t offset) const {
+    const HdxHeader& h = header();
+    if (offset >= h.stringsSize) return "";
+    return reinterpret_cast<const char*>(data + h.stringsOffset + offset);
+}
+
+const char* ScanIndexReader::name(uint32_t id) const {
+    const HdxHeader& h = header();
+    if (id >= h.nameCount) return "";
+    const uint32_t* names = reinterpret_cast<const uint32_t*>(data + h.namesOffset);
+    return string(names[id]);
+}
+
+const HdxField* ScanIndexReader::fields() const {
+    return reinterpret_cast<const HdxField*>(data + header().fieldsOffset);
+}
+
+bool ScanIndexReader::toResults(ResultStore& out) const {
+    out = ResultStore();
+    size_t nextField = 0;
+    std::vector<ResultId> ids(size());
+    // Records whose children are still expected, innermost last, with the
+    // number of children each is still missing
+    std::vector<std::pair<uint32_t, uint32_t>> open;
+
+    // Records are in pre-order: each one belongs to the innermost enclosing
+    // record that still expects children. Files where `parent` says
+    // otherwise are rejected, so the tree is rebuilt in one pass without
+    // trusting the counts for anything but the check.
+    for (size_t index = 0; index < size(); ++index) {
+        const HdxRecord& rec = record(index);
+        while (!open.empty() && open.back().second == 0)
+            open.pop_back();
+        uint32_t expected = open.empty() ? HDX_NONE : open.back().first;
+        if (rec.parent != expected) {
+            Logger::error("Corrupt scan index, record " + std::to_string(index) + " is misplaced");
+            return false;
+        }
+        if (open.size() >= HDX_MAX_DEPTH) {
+            Logger::error("Corrupt scan index, results nested too deep at record " + std::to_string(index));
+            return false;
+        }
+        if (!open.empty())
+            --open.back().second;
+
+        ScanResult r;
+        r.offset = rec.offset;
+        r.length = rec.length;
+        r.type = name(rec.typeId);
+        r.extractorType = rec.extractorId == HDX_NONE ? "" : name(rec.extractorId);
+        r.info = string(rec.info);
+        // The text is already rendered, the fields only come along
+        for (; nextField < header().fieldCount && fields()[nextField].record <= index; ++nextField) {
+            const HdxField& stored = fields()[nextField];
+            if (stored.record != index)
+                continue;
+            InfoField f;
+            f.key = string(stored.key);
+            f.format = static_cast<InfoField::Format>(stored.format);
+            f.number = stored.number;
+            f.text = string(stored.text);
+            r.info.add(std::move(f));
+        }
+        r.isValid = rec.flags & HDX_FLAG_VALID;
+        r.confident = rec.flags & HDX_FLAG_CONFIDENT;
+        r.extracted = rec.flags & HDX_FLAG_EXTRACTED;
+        r.budgetExceeded = rec.flags & HDX_FLAG_BUDGET_EXCEEDED;
+        ResultId parent = rec.parent == HDX_NONE ? NO_RESULT : ids[rec.parent];
+        ids[index] = out.add(r, parent, out.intern(string(rec.source)));
+        if (rec.childCount)
+            open.emplace_back(static_cast<uint32_t>(index), rec.childCount);
+    }
+    for (const auto& pending : open) {
+        if (pending.second) {
+            Logger::error("Corrupt scan index, record " + std::to_string(pending.first) + " misses children");
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include "result_store.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+//
+// HexDig binary scan index (.hdx), format version 1
+//
+// Layout (all integers little-endian, every section 8-byte aligned):
+//
+//   HdxHeader                      fixed 96 bytes at offset 0
+//   HdxRecord[recordCount]         at recordsOffset, recordSize bytes each
+//   uint32_t names[nameCount]      at namesOffset, string-table offsets of the
+//                                  interned type/extractor names
+//   char strings[stringsSize]      at stringsOffset, NUL-terminated strings;
+//                                  offset 0 is always the empty string
+//   HdxField fields[fieldCount]    at fieldsOffset, optional (0 in files
+//                                  written before fields existed): the typed
+//                                  info fields, ordered by record
+//
+// Records are stored in depth-first pre-order: a record's children follow it
+// directly, `parent` is the index of the enclosing record (HDX_NONE for
+// top-level results) and `childCount` the number of direct children.
+// Trees nested deeper than HDX_MAX_DEPTH records are rejected.
+// Readers must reject files whose major `version` they do not know and must
+// use `recordSize` as the stride so that later versions can append fields.
+// `info` holds the rendered text, fields are extra data next to it.
+// `flags` are HdxFlags; HDX_FLAG_BUDGET_EXCEEDED marks results cut short by
+// a scan budget, and the BUDGET marker where a scan stopped.
+//
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The .hdx writer/reader assumes a little-endian host"
+#endif
+
+constexpr char     HDX_MAGIC[4] = {'H', 'D', 'X', '\0'};
+constexpr uint16_t HDX_VERSION  = 1;
+constexpr uint32_t HDX_NONE     = 0xFFFFFFFFu;
+constexpr size_t   HDX_MAX_DEPTH = 1024;  // far beyond any -r a scan can finish
+
+enum HdxFlags : uint32_t {
+    HDX_FLAG_VALID     = 1u << 0,
+    HDX_FLAG_CONFIDENT = 1u << 1,
+    HDX_FLAG_EXTRACTED = 1u << 2,
+    HDX_FLAG_BUDGET_EXCEEDED = 1u << 3,
+};
+
+struct HdxHeader {
+    char     magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t recordSize;
+    uint32_t nameCount;
+    uint64_t recordCount;
+    uint64_t recordsOffset;
+    uint64_t namesOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t inputSize;      // size of the scanned input in bytes
+    uint64_t inputHash;      // content hash of the input, 0 if not computed
+    uint32_t inputName;      // string-table offset of the input path
+    uint32_t parserSet;      // parser-set version the results came from, 0 if unknown
+    uint64_t fieldsOffset;   // 0 if there are no fields
+    uint64_t fieldCount;
+};
+
+struct HdxRecord {
+    uint64_t offset;
+    uint64_t length;
+    uint32_t typeId;         // index into the name table
+    uint32_t extractorId;    // index into the name table, HDX_NONE if no extractor
+    uint32_t parent;         // record index, HDX_NONE for top-level results
+    uint32_t childCount;
+    uint32_t flags;          // HdxFlags
+    uint32_t info;           // string-table offset
+    uint32_t source;         // string-table offset
+    uint32_t reserved;
+};
+
+struct HdxField {
+    uint32_t record;         // record index
+    uint32_t key;            // string-table offset
+    uint64_t number;
+    uint32_t text;           // string-table offset, InfoField::TEXT only
+    uint8_t  format;         // InfoField::Format
+    uint8_t  reserved[3];
+};
+
+static_assert(sizeof(HdxHeader) == 96, "HdxHeader layout changed");
+static_assert(sizeof(HdxField) == 24, "HdxField layout changed");
+static_assert(sizeof(HdxRecord) == 48, "HdxRecord layout changed");
+
+struct ScanIndexMeta {
+    std::string inputName;
+    uint64_t inputSize = 0;
+    uint64_t inputHash = 0;
+    uint32_t parserSet = 0;
+};
+
+bool writeScanIndex(const ResultStore& results, const ScanIndexMeta& meta,
+                    const std::filesystem::path& outPath);
+
+// Read-only view of an .hdx file. The file is memory-mapped where the
+// platform supports it, so opening an index costs no parsing at all.
+class ScanIndexReader {
+public:
+    ScanIndexReader() = default;
+    ~ScanIndexReader();
+    ScanIndexReader(const ScanIndexReader&) = delete;
+    ScanIndexReader& operator=(const ScanIndexReader&) = delete;
+
+    bool open(const std::filesystem::path& path);
+    void close();
+
+    const HdxHeader& header() const { return *reinterpret_cast<const HdxHeader*>(data); }
+    size_t size() const { return static_cast<size_t>(header().recordCount); }
+    const HdxRecord& record(size_t i) const;
+    const char* string(uint32_t offset) const;
+    const char* name(uint32_t id) const;
+    // header().fieldCount entries
+    const HdxField* fields() const;
+
+    // Rebuild the result tree from the flat records. False if the records
+    // do not form a pre-order tree; `out` is then incomplete.
+    bool toResults(ResultStore& out) const;
+
+private:
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    std::vector<uint8_t> buffer;
+};
@@ -0,0 +1,192 @@
+#include "stream_input.hpp"
+#include <algorithm>
+#include <vector>
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+
+// Whether the filesystem reports a hole before the end of the file. Every
+// file ends in an implicit hole, and filesystems without hole support
+// report only that one. Leaves the file offset at 0.
+static bool hasHoles(int fd, uint64_t size) {
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+    off_t hole = size > 0 ? lseek(fd, 0, SEEK_HOLE) : -1;
+    lseek(fd, 0, SEEK_SET);
+    return hole >= 0 && static_cast<uint64_t>(hole) < size;
+#else
+    (void)fd;
+    (void)size;
+    return false;
+#endif
+}
+
+StreamInput::~StreamInput() {
+    if (ownsFd && fd >= 0)
+        ::close(fd);
+}
+
+bool StreamInput::open(const std::filesystem::path& path) {
+    if (path == "-") {
+        fd = STDIN_FILENO;
+        ownsFd = false;
+    } else {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        ownsFd = true;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        seekable = true;
+        fileSize = static_cast<uint64_t>(st.st_size);
+        holes = hasHoles(fd, fileSize);
+    } else {
+        seekable = lseek(fd, 0, SEEK_CUR) >= 0;
+    }
+    pos = 0;
+    return true;
+}
+
+size_t StreamInput::read(uint8_t* dst, size_t count) {
+    size_t have = 0;
+    while (have < count) {
+        ssize_t n = ::read(fd, dst + have, count - have);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        have += static_cast<size_t>(n);
+    }
+    pos += have;
+    return have;
+}
+
+void StreamInput::skip(uint64_t count) {
+    if (count == 0)
+        return;
+    if (seekable && lseek(fd, static_cast<off_t>(pos + count), SEEK_SET) >= 0) {
+        pos += count;
+        return;
+    }
+    std::vector<uint8_t> scratch(std::min<uint64_t>(count, 1u << 20));
+    while (count > 0) {
+        size_t n = read(scratch.data(), std::min<uint64_t>(count, scratch.size()));
+        if (n == 0)
+            break;
+        count -= n;
+    }
+}
+
+uint64_t StreamInput::holeLength() {
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+    if (!sparse() || pos >= fileSize)
+        return 0;
+    off_t data = lseek(fd, static_cast<off_t>(pos), SEEK_DATA);
+    uint64_t hole;
+    if (data >= 0)
+        hole = static_cast<uint64_t>(data) - pos;
+    else if (errno == ENXIO)
+        hole = fileSize - pos;  // only a hole up to the end of the file
+    else
+        hole = 0;           // the filesystem cannot tell
+    // SEEK_DATA moves the file offset, put it back
+    lseek(fd, static_cast<off_t>(pos), SEEK_SET);
+    return hole;
+#else
+    return 0;
+#endif
+}
+
+uint64_t StreamInput::dataLength() {
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+    if (!sparse() || pos >= fileSize)
+        return UINT64_MAX;
+    off_t hole = lseek(fd, static_cast<off_t>(pos), SEEK_HOLE);
+    lseek(fd, static_cast<off_t>(pos), SEEK_SET);
+    return hole >= 0 ? static_cast<uint64_t>(hole) - pos : UINT64_MAX;
+#else
+    return UINT64_MAX;
+#endif
+}
+
+bool isSparseFile(const std::filesystem::path& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st{};
+    bool sparse = fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+                  hasHoles(fd, static_cast<uint64_t>(st.st_size));
+    ::close(fd);
+    return sparse;
+}
+
+#else
+
+StreamInput::~StreamInput() {
+    if (ownsFile && file)
+        std::fclose(file);
+}
+
+bool StreamInput::open(const std::filesystem::path& path) {
+    if (path == "-") {
+        file = stdin;
+        ownsFile = false;
+    } else {
+        file = std::fopen(path.string().c_str(), "rb");
+        if (!file)
+            return false;
+        ownsFile = true;
+        seekable = true;
+        std::error_code ec;
+        fileSize = std::filesystem::file_size(path, ec);
+    }
+    pos = 0;
+    return true;
+}
+
+size_t StreamInput::read(uint8_t* dst, size_t count) {
+    size_t have = 0;
+    while (have < count) {
+        size_t n = std::fread(dst + have, 1, count - have, file);
+        if (n == 0)
+            break;
+        have += n;
+    }
+    pos += have;
+    return have;
+}
+
+void StreamInput::skip(uint64_t count) {
+    if (count == 0)
+        return;
+    if (seekable && _fseeki64(file, static_cast<long long>(pos + count), SEEK_SET) == 0) {
+        pos += count;
+        return;
+    }
+    std::vector<uint8_t> scratch(std::min<uint64_t>(count, 1u << 20));
+    while (count > 0) {
+        size_t n = read(scratch.data(), std::min<uint64_t>(count, scratch.size()));
+        if (n == 0)
+            break;
+        count -= n;
+    }
+}
+
+uint64_t StreamInput::holeLength() {
+    return 0;
+}
+
+uint64_t StreamInput::dataLength() {
+    return UINT64_MAX;
+}
+
+bool isSparseFile(const std::filesystem::path&) {
+    return false;
+}
+
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+// Sequential byte source of a streaming scan. Offsets are logical: input
+// transformers (see input_transform.hpp) present a decoded view of another
+// source and map logical offsets back to the physical file for reporting.
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+
+    // Reads up to `count` bytes; fewer only at the end of the input
+    virtual size_t read(uint8_t* dst, size_t count) = 0;
+    // Moves forward by `count` bytes, seeking where the input allows it
+    virtual void skip(uint64_t count) = 0;
+    // Bytes from the current position to the next data, 0 inside data or
+    // when the input cannot tell; holes read as zeros
+    virtual uint64_t holeLength() { return 0; }
+    // Bytes from the current position to the next hole, UINT64_MAX when
+    // the input has no known holes
+    virtual uint64_t dataLength() { return UINT64_MAX; }
+
+    virtual uint64_t position() const = 0;
+    // Logical size, 0 if unknown (pipes)
+    virtual uint64_t size() const { return 0; }
+
+    // Whether logical offsets differ from offsets in the file on disk
+    virtual bool remapped() const { return false; }
+    virtual uint64_t physicalOffset(uint64_t logical) const { return logical; }
+};
+
+// Reader for regular files, block devices, pipes and stdin ("-"). Where the
+// platform has SEEK_DATA and SEEK_HOLE, the holes of sparse files are
+// reported so that the scanner can jump over them without reading
+// gigabytes of zeros.
+class StreamInput : public InputSource {
+public:
+    StreamInput() = default;
+    ~StreamInput();
+    StreamInput(const StreamInput&) = delete;
+    StreamInput& operator=(const StreamInput&) = delete;
+
+    bool open(const std::filesystem::path& path);
+
+    size_t read(uint8_t* dst, size_t count) override;
+    void skip(uint64_t count) override;
+    uint64_t holeLength() override;
+    uint64_t dataLength() override;
+    uint64_t position() const override { return pos; }
+    uint64_t size() const override { return fileSize; }
+
+    // The filesystem reports a hole before the end of the file
+    bool sparse() const { return holes; }
+
+private:
+#ifndef _WIN32
+    int fd = -1;
+    bool ownsFd = false;
+#else
+    std::FILE* file = nullptr;
+    bool ownsFile = false;
+#endif
+    bool seekable = false;
+    uint64_t pos = 0;
+    uint64_t fileSize = 0;   // regular files only
+    bool holes = false;      // regular files only, looked up once at open
+};
+
+// Checks without opening a stream whether a regular file has holes
+bool isSparseFile(const std::filesystem::path& path);
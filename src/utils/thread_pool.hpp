@@ -0,0 +1,60 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads executing queued tasks in FIFO order.
+class ThreadPool {
+public:
+    // 0 selects std::thread::hardware_concurrency()
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    template <typename F>
+    auto submit(F&& fn) -> std::future<decltype(fn())> {
+        using R = decltype(fn());
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        std::future<R> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([task] { (*task)(); });
+        }
+        cv.notify_one();
+        return result;
+    }
+
+    // Waits for `f`, executing queued tasks on the calling thread meanwhile,
+    // so tasks that wait on sub-tasks cannot starve the pool.
+    template <typename T>
+    T wait(std::future<T>& f) {
+        while (f.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!runOne())
+                f.wait_for(std::chrono::milliseconds(1));
+        }
+        return f.get();
+    }
+
+    // Process-wide pool shared by the analysis stages
+    static ThreadPool& shared();
+
+private:
+    void run();
+    bool runOne();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdio>
+
+// Minimal self-checking for the test executables: a failed CHECK is
+// reported and counted, and main() returns testResult() so that CTest sees
+// a non-zero exit status.
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++testFailures();                                                         \
+        }                                                                             \
+    } while (0)
+
+inline int testResult() {
+    if (testFailures())
+        std::fprintf(stderr, "%d check(s) failed\n", testFailures());
+    return testFailures() ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+#include "aho_corasick.hpp"
+#include "check.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using Hit = std::pair<size_t, uint32_t>;  // start offset, pattern id
+
+static std::vector<Hit> bruteForce(const std::vector<std::vector<uint8_t>>& patterns,
+                                   const std::vector<uint8_t>& text) {
+    std::vector<Hit> hits;
+    for (uint32_t id = 0; id < patterns.size(); ++id) {
+        const auto& p = patterns[id];
+        for (size_t i = 0; i + p.size() <= text.size(); ++i)
+            if (std::memcmp(&text[i], p.data(), p.size()) == 0)
+                hits.emplace_back(i, id);
+    }
+    std::sort(hits.begin(), hits.end());
+    return hits;
+}
+
+static std::vector<Hit> scan(const AhoCorasick& ac, const std::vector<std::vector<uint8_t>>& patterns,
+                             const std::vector<uint8_t>& text, bool* ordered) {
+    std::vector<Hit> hits;
+    size_t lastEnd = 0;
+    *ordered = true;
+    ac.scan(text.data(), text.size(), [&](size_t start, uint32_t id) {
+        size_t end = start + patterns[id].size();
+        *ordered = *ordered && end >= lastEnd;
+        lastEnd = end;
+        hits.emplace_back(start, id);
+    });
+    std::sort(hits.begin(), hits.end());
+    return hits;
+}
+
+// Patterns over a 3-letter alphabet overlap, nest and share prefixes and
+// suffixes all the time, which exercises every failure link
+static void testAgainstBruteForce() {
+    uint32_t x = 1;
+    auto rand = [&] { x = x * 1103515245u + 12345u; return x >> 16; };
+    for (int round = 0; round < 50; ++round) {
+        std::vector<std::vector<uint8_t>> patterns;
+        size_t count = 1 + rand() % 20;
+        for (size_t i = 0; i < count; ++i) {
+            std::vector<uint8_t> p(1 + rand() % 6);
+            for (auto& b : p)
+                b = static_cast<uint8_t>('a' + rand() % 3);
+            patterns.push_back(p);
+        }
+        patterns.push_back(patterns.front());  // the same bytes under two ids
+        std::vector<uint8_t> text(2000);
+        for (auto& b : text)
+            b = static_cast<uint8_t>('a' + rand() % 3);
+
+        AhoCorasick ac;
+        for (uint32_t id = 0; id < patterns.size(); ++id)
+            ac.add(patterns[id].data(), patterns[id].size(), id);
+        ac.build();
+        bool ordered = false;
+        CHECK(scan(ac, patterns, text, &ordered) == bruteForce(patterns, text));
+        CHECK(ordered);
+    }
+}
+
+static void testEdgeCases() {
+    std::vector<std::vector<uint8_t>> patterns = {{0x00, 0xFF}, {0xFF}};
+    AhoCorasick ac;
+    CHECK(ac.empty());
+    ac.add(patterns[0].data(), patterns[0].size(), 0);
+    ac.add(patterns[1].data(), 0, 1);  // empty patterns are ignored
+    CHECK(!ac.empty());
+
+    std::vector<uint8_t> text = {0x00, 0xFF, 0xFF, 0x00};
+    bool ordered = false;
+    CHECK(scan(ac, patterns, text, &ordered).empty());  // not built yet
+    ac.build();
+    CHECK((scan(ac, patterns, text, &ordered) == std::vector<Hit>{{0, 0}}));
+
+    // Adding after build() needs another build()
+    ac.add(patterns[1].data(), patterns[1].size(), 1);
+    ac.build();
+    CHECK(scan(ac, patterns, text, &ordered) == bruteForce(patterns, text));
+    CHECK(scan(ac, patterns, {}, &ordered).empty());
+}
+
+int main() {
+    testAgainstBruteForce();
+    testEdgeCases();
+    return testResult();
+}
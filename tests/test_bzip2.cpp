@@ -0,0 +1,178 @@
+#include "bzip2.hpp"
+#include "thread_pool.hpp"
+#include "check.hpp"
+#include <cstring>
+#include <string>
+#include <vector>
+
+// bzip2 -1 of sampleText(): three blocks, the later two at unaligned bits
+static const uint8_t SAMPLE_BZ2[] = {
+    0x42,0x5a,0x68,0x31,0x31,0x41,0x59,0x26,0x53,0x59,0x83,0x81,0x03,0xcf,0x00,0x79,
+    0x92,0x59,0x80,0x00,0x10,0x40,0x00,0x7f,0xe0,0x1e,0xec,0x80,0x40,0x50,0x04,0x1e,
+    0x00,0x00,0x00,0x00,0x50,0x01,0x88,0xd3,0x4d,0x1a,0x14,0x00,0x62,0x34,0xd3,0x46,
+    0x85,0x00,0x18,0x8d,0x34,0xd1,0xa1,0x40,0x06,0x23,0x4d,0x34,0x68,0x14,0xaa,0xa0,
+    0xd3,0x7e,0xd5,0x55,0x36,0xa0,0xc6,0x9a,0x9c,0x07,0xb4,0x0f,0xc4,0x0f,0x48,0x1e,
+    0x20,0x7c,0x40,0xf3,0x03,0xa0,0x68,0x1e,0x60,0x7f,0x50,0x3f,0x10,0x3c,0xc0,0xd0,
+    0x34,0x0f,0x58,0x1a,0x06,0x81,0xa0,0x68,0x1a,0x06,0x81,0xa0,0x7c,0x40,0xd0,0x34,
+    0x0d,0x03,0xda,0x06,0x81,0xa0,0x68,0x1a,0x06,0x81,0xa0,0x78,0x81,0xa0,0x68,0x1a,
+    0x06,0x81,0xef,0x03,0x40,0xd0,0x34,0x0d,0x03,0x40,0xf7,0x81,0xa0,0x68,0x1a,0x06,
+    0x81,0xa0,0x78,0x81,0xa0,0x68,0x1a,0x06,0x81,0xed,0x03,0x40,0xd0,0x34,0x0d,0x03,
+    0x40,0xd0,0x3e,0x20,0x68,0x1a,0x06,0x81,0xeb,0x03,0x40,0xd0,0x34,0x0d,0x03,0x40,
+    0xd0,0x34,0x0f,0x30,0x34,0x0d,0x03,0xd2,0x06,0x81,0x80,0xc0,0x60,0x30,0x18,0x0c,
+    0x06,0x03,0x80,0xd0,0x18,0x0c,0x06,0x03,0x01,0x80,0xc0,0x60,0x3c,0x7e,0xe1,0x10,
+    0xbf,0x28,0x88,0x5f,0xdc,0x0e,0x81,0xd0,0x3a,0x07,0x40,0xe8,0x1f,0x30,0x3e,0x60,
+    0x7c,0x81,0xf2,0x07,0xa7,0x40,0xd0,0x34,0x0d,0x03,0x40,0xd0,0x34,0x0d,0x03,0x80,
+    0xc0,0x72,0x42,0x68,0x1a,0x07,0xac,0x0d,0x03,0x40,0xd0,0x34,0x0d,0x03,0x01,0x80,
+    0xf2,0x90,0x9a,0x06,0x81,0xa0,0x7b,0x40,0xd0,0x34,0x0d,0x03,0x40,0xc0,0x60,0x3e,
+    0x12,0x13,0x40,0xd0,0x34,0x0d,0x03,0xde,0x06,0x81,0xa0,0x68,0x18,0x0c,0x07,0x84,
+    0x84,0xd0,0x34,0x0d,0x03,0x40,0xd0,0x3c,0x40,0xd0,0x34,0x0c,0x06,0x03,0xdd,0x21,
+    0x3d,0x00,0xd0,0x34,0x0d,0x03,0x40,0xd0,0x34,0x0f,0x30,0x34,0x0c,0x07,0xaa,0x42,
+    0x74,0x0e,0x81,0xd0,0x3a,0x07,0x40,0xe8,0x1d,0x03,0xcc,0x0e,0x03,0xd1,0x21,0x3a,
+    0x07,0x40,0xe8,0x1d,0x03,0xa0,0x74,0x0e,0x81,0xc0,0x75,0x01,0x74,0x0e,0x81,0xd0,
+    0x3a,0x07,0x40,0xe8,0x1d,0x03,0x80,0xe8,0x48,0x97,0xf2,0x11,0x0b,0xed,0x11,0x0b,
+    0xe9,0x11,0x0b,0xf8,0x88,0x85,0xef,0xf9,0x84,0x42,0xfa,0x44,0x42,0xfa,0x84,0x42,
+    0xfa,0x84,0x42,0xfb,0x84,0x42,0xfb,0x44,0x42,0xff,0xcc,0x50,0x56,0x49,0x94,0xd6,
+    0x52,0xd3,0xdf,0x1c,0xc0,0x11,0x91,0xd6,0x60,0x00,0x04,0x10,0x00,0x1f,0xf8,0x07,
+    0xbb,0x20,0x10,0x14,0x01,0x0f,0x80,0x00,0x00,0x00,0x45,0x00,0x18,0x8d,0x34,0xd1,
+    0xa1,0x40,0x06,0x23,0x4d,0x34,0x68,0x50,0x01,0x88,0xd3,0x4d,0x1a,0x14,0x00,0x62,
+    0x34,0xd3,0x46,0x81,0x4a,0xa9,0x30,0xdb,0xd5,0x54,0xc8,0x06,0x9a,0x72,0x07,0x78,
+    0x1e,0xf0,0x3b,0x40,0xf3,0x03,0xd4,0x0e,0xa0,0x72,0x06,0x81,0xd4,0x0f,0xb4,0x0f,
+    0x78,0x1d,0x40,0xd0,0x34,0x0f,0x68,0x1a,0x06,0x81,0xa0,0x68,0x1a,0x06,0x81,0xa0,
+    0x7a,0x81,0xa0,0x68,0x1a,0x07,0x78,0x1a,0x06,0x81,0xa0,0x68,0x1a,0x06,0x81,0xe6,
+    0x06,0x81,0xa0,0x68,0x1a,0x07,0x88,0x1a,0x06,0x81,0xa0,0x68,0x1a,0x07,0x88,0x1a,
+    0x06,0x81,0xa0,0x68,0x1a,0x07,0x98,0x1a,0x06,0x81,0xa0,0x68,0x1d,0xe0,0x68,0x1a,
+    0x06,0x81,0xa0,0x68,0x18,0x0f,0x40,0x60,0x30,0x18,0x0f,0x1d,0xe0,0x60,0x30,0x18,
+    0x0c,0x06,0x03,0xd0,0x18,0x0e,0x80,0xc0,0x60,0x3b,0x40,0xc0,0x60,0x34,0x0d,0x03,
+    0x40,0xd0,0x34,0x0d,0x03,0x90,0x32,0x06,0x81,0xa0,0x68,0x1a,0x06,0x81,0xa0,0x68,
+    0x1f,0xd4,0x44,0x2f,0xdc,0x22,0x17,0xde,0x07,0x50,0x3a,0x81,0xd4,0x0e,0xa0,0x75,
+    0x03,0xe2,0x07,0xc0,0x1f,0x00,0x7c,0x40,0xe4,0x0d,0x03,0x40,0xd0,0x34,0x0d,0x03,
+    0x40,0xc0,0x68,0x1a,0x07,0x12,0x13,0x40,0xd0,0x3d,0xa0,0x68,0x1a,0x06,0x81,0xa0,
+    0x60,0x34,0x0d,0x03,0xa4,0x84,0xd0,0x34,0x0d,0x03,0xbc,0x0d,0x03,0x40,0xd0,0x30,
+    0x1a,0x06,0x81,0xe9,0x21,0x34,0x0d,0x03,0x40,0xd0,0x3c,0x40,0xd0,0x34,0x0c,0x06,
+    0x81,0xa0,0x79,0x48,0x4d,0x03,0x40,0xd0,0x34,0x0d,0x03,0xcc,0x0c,0x06,0x03,0x40,
+    0xd0,0x3c,0x24,0x27,0x68,0x1a,0x06,0x81,0xa0,0x68,0x1a,0x06,0x03,0xa8,0x18,0x0d,
+    0x03,0xd9,0x41,0x39,0x03,0x90,0x39,0x03,0x90,0x39,0x03,0x80,0x70,0x0e,0xa0,0x72,
+    0x07,0x60,0x13,0x90,0x39,0x03,0x90,0x39,0x03,0x90,0x38,0x07,0x00,0xe4,0x0e,0x52,
+    0x0b,0x90,0x39,0x03,0x90,0x39,0x03,0x90,0x38,0x07,0x00,0xe4,0x0e,0x08,0x14,0xef,
+    0xd8,0x24,0x3f,0xc8,0x88,0x5f,0x50,0x88,0x5f,0x30,0x88,0x5f,0xe8,0x44,0x2f,0xdc,
+    0x22,0x17,0xcc,0x22,0x17,0xca,0x22,0x17,0xca,0x22,0x17,0xd2,0x22,0x17,0xd4,0x22,
+    0x17,0xcc,0x50,0x56,0x49,0x94,0xd6,0x43,0xdd,0x15,0xc2,0x40,0x06,0xac,0xf6,0x60,
+    0x00,0x04,0x10,0x00,0x1f,0xf8,0x07,0xbb,0x20,0x10,0x14,0x00,0xe7,0x80,0x00,0x00,
+    0x3c,0x14,0x00,0x62,0x34,0xd3,0x46,0x85,0x00,0x18,0x8d,0x34,0xd1,0xa1,0x40,0x06,
+    0x23,0x4d,0x34,0x68,0x26,0xaa,0xa0,0x01,0x90,0x1e,0x9a,0x81,0x4a,0xaa,0x34,0xd3,
+    0xdb,0xd5,0x28,0x40,0x07,0x8e,0x50,0xf6,0xa1,0xf1,0x43,0xd2,0x87,0x8a,0x1e,0xf4,
+    0x3a,0xa1,0xca,0x1a,0x87,0x54,0x3b,0xa1,0xf1,0x43,0xaa,0x1a,0x86,0xa1,0xeb,0x43,
+    0x50,0xd4,0x35,0x0d,0x43,0x50,0xd4,0x35,0x0f,0x7a,0x1a,0x86,0xa1,0xa8,0x78,0xa1,
+    0xa8,0x6a,0x1a,0x86,0xa1,0xa8,0x6a,0x1e,0x68,0x6a,0x1a,0x86,0xa1,0xa8,0x7b,0x50,
+    0xd4,0x35,0x0d,0x43,0x50,0xd4,0x3d,0xa8,0x6a,0x1a,0x86,0xa1,0xa8,0x6a,0x1e,0x68,
+    0x6a,0x1a,0x86,0xa1,0xa8,0x78,0xa1,0xa8,0x6a,0x1a,0x86,0xa1,0xa8,0x6a,0x1e,0xe4,
+    0x62,0x31,0x18,0x8f,0x5a,0x18,0x8c,0x46,0x23,0x11,0x88,0xc4,0x62,0x3a,0x23,0x11,
+    0x88,0xf4,0xa1,0x88,0xc4,0x62,0x31,0x18,0x8c,0x46,0x23,0x11,0xc2,0x35,0x43,0x11,
+    0x88,0xd4,0x35,0x0d,0x43,0x50,0xd4,0x3f,0x72,0xa4,0x97,0xe6,0x54,0x92,0xfa,0xa1,
+    0xd5,0x0e,0xa8,0x75,0x43,0xaa,0x1d,0x50,0xf9,0xa1,0xf2,0x47,0xc9,0x1f,0x32,0x39,
+    0x43,0x50,0xd4,0x35,0x0d,0x43,0x50,0xd4,0x31,0x18,0x8d,0x43,0x8a,0xa4,0xd4,0x35,
+    0x0f,0x5a,0x1a,0x86,0xa1,0xa8,0x6a,0x18,0x8c,0x46,0xa1,0xd2,0xa9,0x35,0x0d,0x43,
+    0x50,0xf1,0x43,0x50,0xd4,0x35,0x0c,0x46,0x23,0x50,0xf7,0x55,0x26,0xa1,0xa8,0x6a,
+    0x1a,0x87,0xb5,0x0d,0x43,0x50,0xc4,0x62,0x35,0x0f,0x2a,0xa4,0xd4,0x35,0x0d,0x43,
+    0x50,0xd4,0x3c,0xd0,0xd4,0x3e,0xbb,0x23,0xb2,0x3b,0xa1,0xe5,0x54,0x9e,0x94,0x3b,
+    0xa1,0xdd,0x0e,0xe8,0x77,0x43,0xba,0x1d,0x91,0xd5,0x0c,0x46,0x23,0xd5,0x0a,0x72,
+    0x87,0x28,0x72,0x87,0x28,0x72,0x87,0x08,0xe1,0x1d,0x50,0xe1,0x1e,0x82,0x53,0x94,
+    0x39,0x43,0x94,0x39,0x43,0x94,0x38,0x47,0x08,0xe1,0x1c,0x54,0x97,0x28,0x72,0x87,
+    0x28,0x72,0x87,0x28,0x70,0x8e,0x11,0xc2,0x38,0x44,0xa3,0x64,0x24,0x99,0x42,0x49,
+    0x84,0x24,0x9b,0x21,0x24,0xf2,0x84,0x93,0x08,0x49,0x30,0x84,0x93,0x08,0x49,0x32,
+    0x84,0x93,0x28,0x49,0x3f,0x8b,0xb9,0x22,0x9c,0x28,0x48,0x4b,0xf7,0x50,0x68,0x80,
+};
+
+static std::vector<uint8_t> sampleText() {
+    std::string s;
+    for (int i = 0; i < 16000; ++i)
+        s += "hexdig block " + std::to_string(i % 97) + "\n";
+    return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+static std::vector<uint8_t> decompress(const std::vector<uint8_t>& data, ThreadPool* pool, bool* ok) {
+    std::vector<uint8_t> out;
+    *ok = bzip2_decompress(data.data(), data.size(), 0, [&](const uint8_t* p, size_t len) {
+        out.insert(out.end(), p, p + len);
+        return true;
+    }, pool);
+    return out;
+}
+
+// Both magics at every bit phase, after a prefix of random-looking bytes
+static void testMarkerSearch() {
+    for (uint64_t magic : {BZ2_BLOCK_MAGIC, BZ2_EOS_MAGIC}) {
+        for (unsigned shift = 0; shift < 8; ++shift) {
+            std::vector<uint8_t> buf(32, 0xA5);
+            uint64_t bit = 5 * 8 + shift;
+            for (unsigned i = 0; i < 48; ++i) {
+                uint64_t b = bit + i;
+                uint8_t mask = static_cast<uint8_t>(0x80 >> (b % 8));
+                if ((magic >> (47 - i)) & 1)
+                    buf[b / 8] |= mask;
+                else
+                    buf[b / 8] &= static_cast<uint8_t>(~mask);
+            }
+            Bzip2Marker marker{};
+            CHECK(bzip2_next_marker(buf.data(), buf.size(), 0, marker));
+            CHECK(marker.bit == bit);
+            CHECK(marker.eos == (magic == BZ2_EOS_MAGIC));
+            CHECK(bzip2_read_bits(buf.data(), buf.size(), bit, 24) == uint32_t(magic >> 24));
+            CHECK(!bzip2_next_marker(buf.data(), buf.size(), bit + 1, marker));
+        }
+    }
+}
+
+static void testMember() {
+    Bzip2Member member;
+    CHECK(bzip2_scan_member(SAMPLE_BZ2, sizeof(SAMPLE_BZ2), 0, member));
+    CHECK(member.level == 1);
+    CHECK(member.complete);
+    CHECK(member.crcMatches);
+    CHECK(member.length == sizeof(SAMPLE_BZ2));
+    CHECK(member.blocks.size() == 3);
+    CHECK(!member.blocks.empty() && member.blocks[0].bitOffset == 32);
+
+    std::vector<uint8_t> text = sampleText();
+    std::vector<uint8_t> out;
+    for (const Bzip2Block& block : member.blocks)
+        CHECK(bzip2_decode_block(SAMPLE_BZ2, sizeof(SAMPLE_BZ2), block.bitOffset, member.level, out));
+    CHECK(out == text);
+}
+
+static void testDecompress() {
+    std::vector<uint8_t> data(SAMPLE_BZ2, SAMPLE_BZ2 + sizeof(SAMPLE_BZ2));
+    std::vector<uint8_t> text = sampleText();
+    bool ok = false;
+    CHECK(decompress(data, nullptr, &ok) == text);
+    CHECK(ok);
+
+    // Parallel decoding delivers the same bytes in order; two members
+    // decode one after the other
+    ThreadPool pool(4);
+    data.insert(data.end(), SAMPLE_BZ2, SAMPLE_BZ2 + sizeof(SAMPLE_BZ2));
+    std::vector<uint8_t> twice = text;
+    twice.insert(twice.end(), text.begin(), text.end());
+    CHECK(decompress(data, &pool, &ok) == twice);
+    CHECK(ok);
+
+    // A damaged block fails its CRC, the blocks before it are delivered
+    data.assign(SAMPLE_BZ2, SAMPLE_BZ2 + sizeof(SAMPLE_BZ2));
+    data[data.size() / 2] ^= 0x10;
+    std::vector<uint8_t> partial = decompress(data, &pool, &ok);
+    CHECK(!ok);
+    CHECK(partial.size() < text.size());
+    CHECK(std::memcmp(partial.data(), text.data(), partial.size()) == 0);
+
+    // Cut short: no end-of-stream marker
+    data.assign(SAMPLE_BZ2, SAMPLE_BZ2 + sizeof(SAMPLE_BZ2) - 20);
+    Bzip2Member member;
+    CHECK(!bzip2_scan_member(data.data(), data.size(), 0, member) || !member.complete);
+}
+
+int main() {
+    testMarkerSearch();
+    testMember();
+    testDecompress();
+    return testResult();
+}
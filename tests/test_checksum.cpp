@@ -0,0 +1,65 @@
+#include "checksum.hpp"
+#include "check.hpp"
+#include <zlib.h>
+#include <cstring>
+#include <vector>
+
+// Deterministic bytes, so a failure can be reproduced
+static std::vector<uint8_t> pattern(size_t size) {
+    std::vector<uint8_t> out(size);
+    uint32_t x = 0x12345678;
+    for (auto& b : out) {
+        x = x * 1103515245u + 12345u;
+        b = static_cast<uint8_t>(x >> 24);
+    }
+    return out;
+}
+
+// The catalogue check values over "123456789"
+static void testCheckValues() {
+    const uint8_t* check = reinterpret_cast<const uint8_t*>("123456789");
+    CHECK(crc32_ieee(check, 9) == 0xCBF43926u);
+    CHECK(crc32_ieee_portable(check, 9) == 0xCBF43926u);
+    CHECK(crc32c(check, 9) == 0xE3069283u);
+    CHECK(crc32c_portable(check, 9) == 0xE3069283u);
+    CHECK(crc32_msb(check, 9) == 0xFC891918u);
+    CHECK(crc16(check, 9) == 0xBB3Du);
+    CHECK(crc32_ieee(check, 0) == 0);
+    CHECK(crc32c(check, 0) == 0);
+}
+
+// Whichever path the CPU selected agrees with the tables and with zlib at
+// every length around the 16- and 64-byte folding steps, at every
+// alignment, and when fed in pieces
+static void testAgainstTables() {
+    std::vector<uint8_t> data = pattern((1u << 20) + 64);
+    std::vector<size_t> lengths;
+    for (size_t len = 0; len <= 300; ++len)
+        lengths.push_back(len);
+    for (size_t len : {size_t(4095), size_t(4096), size_t(4097), size_t(65537), size_t(1) << 20})
+        lengths.push_back(len);
+
+    for (size_t align = 0; align < 16; ++align) {
+        for (size_t len : lengths) {
+            const uint8_t* p = data.data() + align;
+            uint32_t expected = crc32_ieee_portable(p, len);
+            CHECK(crc32_ieee(p, len) == expected);
+            CHECK(expected == static_cast<uint32_t>(::crc32(0, p, static_cast<uInt>(len))));
+            CHECK(crc32c(p, len) == crc32c_portable(p, len));
+        }
+    }
+
+    const uint8_t* p = data.data();
+    size_t len = data.size() - 64;
+    for (size_t split : {size_t(1), size_t(63), size_t(64), size_t(1000), len / 2}) {
+        CHECK(crc32_ieee(p + split, len - split, crc32_ieee(p, split)) == crc32_ieee_portable(p, len));
+        CHECK(crc32c(p + split, len - split, crc32c(p, split)) == crc32c_portable(p, len));
+        CHECK(crc32_msb(p + split, len - split, crc32_msb(p, split)) == crc32_msb(p, len));
+    }
+}
+
+int main() {
+    testCheckValues();
+    testAgainstTables();
+    return testResult();
+}
@@ -0,0 +1,195 @@
+#include "scan_index.hpp"
+#include "check.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static ScanResult makeResult(uint64_t offset, const char* type, uint32_t flags) {
+    ScanResult r;
+    r.offset = offset;
+    r.length = 0x100 + offset;
+    r.type = type;
+    r.isValid = flags & HDX_FLAG_VALID;
+    r.confident = flags & HDX_FLAG_CONFIDENT;
+    r.extracted = flags & HDX_FLAG_EXTRACTED;
+    r.budgetExceeded = flags & HDX_FLAG_BUDGET_EXCEEDED;
+    return r;
+}
+
+// Two top-level results, one with a child that has a child of its own
+static ResultStore sampleResults() {
+    ResultStore store;
+    ScanResult gzip = makeResult(0x40, "GZIP", HDX_FLAG_VALID | HDX_FLAG_CONFIDENT | HDX_FLAG_EXTRACTED);
+    gzip.extractorType = "GZIP";
+    gzip.info.text("GZIP stream, flags=0x").field("flags", 0x1f, InfoField::HEX)
+             .text(", name=").field("name", std::string("root.tar"));
+    ResultId top = store.add(gzip, NO_RESULT, store.intern("fw.bin"));
+
+    ScanResult tar = makeResult(0, "TAR", HDX_FLAG_VALID | HDX_FLAG_EXTRACTED);
+    tar.info = "POSIX tar archive";
+    ResultId child = store.add(tar, top, store.intern("fw.bin.extracted/40/decompressed.bin"));
+    store.add(makeResult(0x200, "ELF", HDX_FLAG_VALID), child, store.intern("fw.bin.extracted/40/bin/sh"));
+
+    ScanResult budget = makeResult(0x9000, "BUDGET", HDX_FLAG_VALID | HDX_FLAG_BUDGET_EXCEEDED);
+    budget.info = "Scan stopped, budget exceeded";
+    store.add(budget, NO_RESULT, store.intern("fw.bin"));
+    return store;
+}
+
+static bool sameTrees(const std::vector<ResultView>& a, const std::vector<ResultView>& b);
+
+static std::vector<ResultView> list(ResultView::Range range) {
+    std::vector<ResultView> out;
+    for (ResultView r : range)
+        out.push_back(r);
+    return out;
+}
+
+static bool sameTree(ResultView a, ResultView b) {
+    if (a.offset() != b.offset() || a.length() != b.length() || a.type() != b.type() ||
+        a.extractorType() != b.extractorType() || a.source() != b.source() || a.info() != b.info() ||
+        a.isValid() != b.isValid() || a.confident() != b.confident() ||
+        a.extracted() != b.extracted() || a.budgetExceeded() != b.budgetExceeded())
+        return false;
+    std::vector<InfoField> fa = a.fields(), fb = b.fields();
+    if (fa.size() != fb.size())
+        return false;
+    for (size_t i = 0; i < fa.size(); ++i)
+        if (std::strcmp(fa[i].key, fb[i].key) != 0 || fa[i].format != fb[i].format ||
+            fa[i].number != fb[i].number || fa[i].text != fb[i].text)
+            return false;
+    return sameTrees(list(a.children()), list(b.children()));
+}
+
+static bool sameTrees(const std::vector<ResultView>& a, const std::vector<ResultView>& b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (!sameTree(a[i], b[i]))
+            return false;
+    return true;
+}
+
+static std::vector<uint8_t> readFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const fs::path& path, const std::vector<uint8_t>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+static HdxRecord& recordAt(std::vector<uint8_t>& file, size_t i) {
+    const HdxHeader* h = reinterpret_cast<const HdxHeader*>(file.data());
+    return *reinterpret_cast<HdxRecord*>(file.data() + h->recordsOffset + i * h->recordSize);
+}
+
+// A file whose records have been edited must open but not load
+static bool loads(const fs::path& path, const std::vector<uint8_t>& file) {
+    writeFile(path, file);
+    ScanIndexReader reader;
+    ResultStore out;
+    return reader.open(path) && reader.toResults(out);
+}
+
+static void testRoundTrip(const fs::path& dir) {
+    ResultStore results = sampleResults();
+    ScanIndexMeta meta;
+    meta.inputName = "fw.bin";
+    meta.inputSize = 0x10000;
+    meta.inputHash = 0x0123456789abcdefull;
+    meta.parserSet = 7;
+    fs::path path = dir / "sample.hdx";
+    CHECK(writeScanIndex(results, meta, path));
+
+    ScanIndexReader reader;
+    CHECK(reader.open(path));
+    CHECK(reader.size() == results.size());
+    CHECK(reader.header().inputSize == meta.inputSize);
+    CHECK(reader.header().inputHash == meta.inputHash);
+    CHECK(reader.header().parserSet == meta.parserSet);
+    CHECK(std::string(reader.string(reader.header().inputName)) == "fw.bin");
+    CHECK(reader.record(3).flags == (HDX_FLAG_VALID | HDX_FLAG_BUDGET_EXCEEDED));
+
+    ResultStore back;
+    CHECK(reader.toResults(back));
+    CHECK(back.size() == results.size());
+    CHECK(sameTrees(list(results.topLevel()), list(back.topLevel())));
+}
+
+static void testCorruptFiles(const fs::path& dir) {
+    fs::path good = dir / "sample.hdx";
+    fs::path path = dir / "corrupt.hdx";
+    std::vector<uint8_t> file = readFile(good);
+    CHECK(loads(path, file));
+
+    // Cut anywhere: the header or a section no longer fits
+    for (size_t size : {size_t(0), size_t(10), sizeof(HdxHeader), file.size() / 2, file.size() - 1}) {
+        writeFile(path, std::vector<uint8_t>(file.begin(), file.begin() + size));
+        ScanIndexReader reader;
+        CHECK(!reader.open(path));
+    }
+
+    std::vector<uint8_t> bad = file;
+    bad[0] = 'X';
+    writeFile(path, bad);
+    ScanIndexReader reader;
+    CHECK(!reader.open(path));
+
+    // A parent that does not enclose the record, or one after it
+    bad = file;
+    recordAt(bad, 2).parent = 0;
+    CHECK(!loads(path, bad));
+    bad = file;
+    recordAt(bad, 1).parent = 2;
+    CHECK(!loads(path, bad));
+    bad = file;
+    recordAt(bad, 3).parent = HDX_NONE - 1;
+    CHECK(!loads(path, bad));
+
+    // Child counts that disagree with the parents, including the "every
+    // record has one child" chain that used to recurse once per record
+    bad = file;
+    recordAt(bad, 2).childCount = 1;
+    CHECK(!loads(path, bad));
+    bad = file;
+    recordAt(bad, 0).childCount = 0;
+    CHECK(!loads(path, bad));
+    bad = file;
+    for (size_t i = 0; i < 4; ++i)
+        recordAt(bad, i).childCount = 1;
+    CHECK(!loads(path, bad));
+}
+
+// A consistent chain nested deeper than HDX_MAX_DEPTH is refused
+static void testDepthLimit(const fs::path& dir) {
+    for (size_t depth : {HDX_MAX_DEPTH, HDX_MAX_DEPTH + 1}) {
+        ResultStore chain;
+        ResultId parent = NO_RESULT;
+        for (size_t i = 0; i < depth; ++i)
+            parent = chain.add(makeResult(i, "ZLIB", HDX_FLAG_VALID), parent);
+        fs::path path = dir / "chain.hdx";
+        CHECK(writeScanIndex(chain, ScanIndexMeta(), path));
+        ScanIndexReader reader;
+        ResultStore out;
+        CHECK(reader.open(path));
+        CHECK(reader.toResults(out) == (depth <= HDX_MAX_DEPTH));
+    }
+}
+
+int main() {
+    fs::path dir = fs::temp_directory_path() /
+                   ("hexdig_test_scan_index_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    fs::create_directories(dir);
+    testRoundTrip(dir);
+    testCorruptFiles(dir);
+    testDepthLimit(dir);
+    fs::remove_all(dir);
+    return testResult();
+}